@@ -1372,6 +1372,70 @@ class TestAdminCommandDumpLoads(CephFSTestCase):
         for d in loads["dirfrags"]:
             self.assertLessEqual(d["path"].count("/"), 1)
 
+class TestAdminCommandBalancerPlan(CephFSTestCase):
+    """
+    Tests for administration command balancer plan.
+    """
+
+    CLIENTS_REQUIRED = 1
+    MDSS_REQUIRED = 2
+
+    def setUp(self):
+        super().setUp()
+        self.fs.set_max_mds(2)
+        self.fs.wait_for_daemons()
+        self.config_set('mds', 'mds_bal_predictive', True)
+        self.config_set('mds', 'mds_bal_interval', 2)
+
+    def _generate_load(self, seconds):
+        """
+        Keep rank 0 busy with creates and unlinks in a few directories, which
+        unlike lookups cannot be served from the client's cache.
+        """
+        self.mount_a.run_shell_payload("mkdir -p load/dir{0..7}")
+        payload = f"""
+            end=$((SECONDS+{seconds}))
+            while [ $SECONDS -lt $end ]; do
+                for d in load/dir*; do
+                    touch $d/file{{0..31}}
+                    rm -f $d/file*
+                done
+            done
+        """
+        return self.mount_a.run_shell_payload(payload, wait=False,
+                                              timeout=seconds + 60)
+
+    def test_balancer_plan(self):
+        """
+        make sure a dry run of the balancer reports its targets and exports
+        once rank 0 carries all of the load.
+        """
+
+        p = self._generate_load(180)
+
+        def plan_has_exports():
+            plan = self.fs.rank_asok(['balancer', 'plan'], rank=0)
+            log.info(f"balancer plan: {plan}")
+            self.assertTrue(plan["predictive"])
+            return len(plan["targets"]) > 0 and len(plan["exports"]) > 0
+
+        self.wait_until_true(plan_has_exports, timeout=150)
+        p.wait()
+
+    def test_balancer_plan_repeatable(self):
+        """
+        make sure a dry run does not change the balancer's state: two
+        consecutive plans within the same epoch are identical.
+        """
+
+        for _ in range(3):
+            plan1 = self.fs.rank_asok(['balancer', 'plan'], rank=0)
+            plan2 = self.fs.rank_asok(['balancer', 'plan'], rank=0)
+            # a heartbeat in between legitimately moves the predictions
+            if plan1["epoch"] == plan2["epoch"]:
+                break
+        self.assertEqual(plan1, plan2)
+
 class TestFsBalRankMask(CephFSTestCase):
     """
     Tests ceph fs set <fs_name> bal_rank_mask
@@ -139,6 +139,7 @@ then
 fi
 expect_false _sudo rbd device --device-type nbd map INVALIDIMAGE
 expect_false _sudo rbd-nbd --device INVALIDDEV map ${IMAGE}
+expect_false _sudo rbd-nbd --num-connections 2 map ${POOL}/${IMAGE}
 
 # list format test
 expect_false rbd device --device-type nbd --format INVALID list
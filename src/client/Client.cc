@@ -9325,6 +9325,25 @@ int Client::_readdir_cache_cb(dir_result_t *dirp, add_dirent_cb_t cb, void *p,
   return 0;
 }
 
+static void fill_readdir_args(dir_result_t* dirp,
+			      MetaRequest* req,
+			      InodeRef& diri,
+			      frag_t fg)
+{
+  filepath path;
+  diri->make_nosnap_relative_path(path);
+  req->set_filepath(path);
+  req->set_inode(diri.get());
+  req->head.args.readdir.frag = fg;
+  req->head.args.readdir.flags = CEPH_READDIR_REPLY_BITFLAGS;
+  if (dirp->last_name.length()) {
+    req->path2.set_path(dirp->last_name);
+  } else if (dirp->hash_order()) {
+    req->head.args.readdir.offset_hash = dirp->offset_high();
+  }
+  req->dirp = dirp;
+}
+
 int Client::readdir_r_cb(dir_result_t* d,
   add_dirent_cb_t cb,
   void* p,
@@ -9332,30 +9351,13 @@ int Client::readdir_r_cb(dir_result_t* d,
   unsigned flags,
   bool getref)
 {
-  auto fill_readdir_cb = [](dir_result_t* dirp,
-			    MetaRequest* req,
-			    InodeRef& diri,
-			    frag_t fg) {
-    filepath path;
-    diri->make_nosnap_relative_path(path);
-    req->set_filepath(path);
-    req->set_inode(diri.get());
-    req->head.args.readdir.frag = fg;
-    req->head.args.readdir.flags = CEPH_READDIR_REPLY_BITFLAGS;
-    if (dirp->last_name.length()) {
-      req->path2.set_path(dirp->last_name);
-    } else if (dirp->hash_order()) {
-      req->head.args.readdir.offset_hash = dirp->offset_high();
-    }
-    req->dirp = dirp;
-  };
   int op = CEPH_MDS_OP_READDIR;
   if (d->inode && d->inode->snapid == CEPH_SNAPDIR)
     op = CEPH_MDS_OP_LSSNAP;
   return _readdir_r_cb(op,
     d,
     cb,
-    fill_readdir_cb,
+    fill_readdir_args,
     p,
     want,
     flags,
@@ -10113,6 +10115,9 @@ Fh *Client::_create_fh(Inode *in, int flags, int cmode, const UserPerm& perms)
     max_readahead = std::min(max_readahead, in->layout.get_period()*(uint64_t)conf->client_readahead_max_periods);
   }
   f->readahead.set_max_readahead_size(max_readahead);
+  f->readahead_max_bytes = max_readahead;
+  f->readahead.set_max_streams(conf->client_readahead_streams);
+  f->readahead.set_detect_patterns(conf->client_readahead_detect_patterns);
   vector<uint64_t> alignments;
   alignments.push_back(in->layout.get_period());
   alignments.push_back(in->layout.stripe_unit);
@@ -10857,7 +10862,7 @@ done:
 }
 
 Client::C_Readahead::C_Readahead(Client *c, Fh *f) :
-    client(c), f(f) {
+    client(c), f(f), start(ceph_clock_now()) {
   f->get();
   f->readahead.inc_pending();
 }
@@ -10872,14 +10877,60 @@ void Client::C_Readahead::finish(int r) {
   client->put_cap_ref(f->inode.get(), CEPH_CAP_FILE_RD | CEPH_CAP_FILE_CACHE);
   if (r > 0) {
     client->update_read_io_size(r);
+    double lat = (ceph_clock_now() - start);
+    if (f->readahead_latency == 0) {
+      f->readahead_latency = lat;
+    } else {
+      f->readahead_latency = (f->readahead_latency * 7 + lat) / 8;
+    }
+  }
+}
+
+void Client::adapt_readahead(Fh *f, uint64_t len)
+{
+  utime_t now = ceph_clock_now();
+  if (f->readahead_last_read != utime_t()) {
+    double interval = now - f->readahead_last_read;
+    if (interval > 0) {
+      double rate = len / interval;
+      if (f->read_rate == 0) {
+	f->read_rate = rate;
+      } else {
+	f->read_rate = (f->read_rate * 7 + rate) / 8;
+      }
+    }
+  }
+  f->readahead_last_read = now;
+
+  if (f->read_rate == 0 || f->readahead_latency == 0) {
+    return;
+  }
+  // enough to cover what the reader consumes while a readahead is in flight,
+  // doubled so that the next one is issued before this one is used up
+  uint64_t max_readahead = f->read_rate * f->readahead_latency * 2;
+  max_readahead = std::max(max_readahead, f->readahead.get_min_readahead_size());
+  max_readahead = std::min(max_readahead, f->readahead_max_bytes);
+  if (max_readahead != f->readahead.get_max_readahead_size()) {
+    ldout(cct, 20) << __func__ << " " << f << " max readahead "
+		   << f->readahead.get_max_readahead_size() << " -> "
+		   << max_readahead << " (rate " << f->read_rate
+		   << " latency " << f->readahead_latency << ")" << dendl;
+    f->readahead.set_max_readahead_size(max_readahead);
   }
 }
 
 void Client::do_readahead(Fh *f, Inode *in, uint64_t off, uint64_t len)
 {
   if(f->readahead.get_min_readahead_size() > 0) {
-    pair<uint64_t, uint64_t> readahead_extent = f->readahead.update(off, len, in->size);
-    if (readahead_extent.second > 0) {
+    if (cct->_conf->client_readahead_adaptive) {
+      adapt_readahead(f, len);
+    }
+    vector<pair<uint64_t, uint64_t>> readahead_extents;
+    f->readahead.update(off, len, in->size, &readahead_extents);
+    for (auto& readahead_extent : readahead_extents) {
+      if (readahead_extent.second == 0) {
+	continue;
+      }
       ldout(cct, 20) << "readahead " << readahead_extent.first << "~" << readahead_extent.second
 		     << " (caller wants " << off << "~" << len << ")" << dendl;
       Context *onfinish2 = new C_Readahead(this, f);
@@ -11061,6 +11112,12 @@ int Client::write(int fd, const char *buf, loff_t size, loff_t offset)
   tout(cct) << size << std::endl;
   tout(cct) << offset << std::endl;
 
+  /* We can't return bytes written larger than INT_MAX, clamp size to that */
+  size = std::min(size, (loff_t)INT_MAX);
+  bufferlist bl;
+  if (size > 0)
+    bl.append(buf, size);
+
   std::scoped_lock lock(client_lock);
   Fh *fh = get_filehandle(fd);
   if (!fh)
@@ -11069,9 +11126,7 @@ int Client::write(int fd, const char *buf, loff_t size, loff_t offset)
   if (fh->flags & O_PATH)
     return -CEPHFS_EBADF;
 #endif
-  /* We can't return bytes written larger than INT_MAX, clamp size to that */
-  size = std::min(size, (loff_t)INT_MAX);
-  int r = _write(fh, offset, size, buf, NULL, false);
+  int r = _write(fh, offset, size, std::move(bl));
   ldout(cct, 3) << "write(" << fd << ", \"...\", " << size << ", " << offset << ") = " << r << dendl;
   return r;
 }
@@ -11292,6 +11347,25 @@ bool Client::C_Write_Finisher::try_complete()
 int64_t Client::_write(Fh *f, int64_t offset, uint64_t size, const char *buf,
 	                const struct iovec *iov, int iovcnt, Context *onfinish,
 	                bool do_fsync, bool syncdataonly)
+{
+  // copy into fresh buffer (since our write may be resub, async)
+  bufferlist bl;
+  if (buf) {
+    if (size > 0)
+      bl.append(buf, size);
+  } else if (iov){
+    for (int i = 0; i < iovcnt; i++) {
+      if (iov[i].iov_len > 0) {
+        bl.append((const char *)iov[i].iov_base, iov[i].iov_len);
+      }
+    }
+  }
+  return _write(f, offset, size, std::move(bl), onfinish, do_fsync,
+                syncdataonly);
+}
+
+int64_t Client::_write(Fh *f, int64_t offset, uint64_t size, bufferlist&& bl,
+	                Context *onfinish, bool do_fsync, bool syncdataonly)
 {
   ceph_assert(ceph_mutex_is_locked_by_me(client_lock));
 
@@ -11357,19 +11431,6 @@ int64_t Client::_write(Fh *f, int64_t offset, uint64_t size, const char *buf,
     ceph_assert(in->inline_version > 0);
   }
 
-  // copy into fresh buffer (since our write may be resub, async)
-  bufferlist bl;
-  if (buf) {
-    if (size > 0)
-      bl.append(buf, size);
-  } else if (iov){
-    for (int i = 0; i < iovcnt; i++) {
-      if (iov[i].iov_len > 0) {
-        bl.append((const char *)iov[i].iov_base, iov[i].iov_len);
-      }
-    }
-  }
-
   int want, have;
   if (f->mode & CEPH_FILE_MODE_LAZY)
     want = CEPH_CAP_FILE_BUFFER | CEPH_CAP_FILE_LAZYIO;
@@ -12018,6 +12079,190 @@ int Client::statxat(int dirfd, const char *relpath,
   return r;
 }
 
+/*
+ * Would looking up and stat'ing dname in dir be answered from the cache,
+ * i.e. without a request to the MDS?  Mirrors the hit checks of _lookup().
+ */
+bool Client::_statx_cached(Inode *dir, const string& dname, int mask)
+{
+  if (!dir->dir)
+    return false;
+  auto it = dir->dir->dentries.find(dname);
+  if (it == dir->dir->dentries.end())
+    return false;
+  Dentry *dn = it->second;
+  if (dn->inode && !dn->inode->caps_issued_mask(mask, true))
+    return false;
+  if (dir->caps_issued_mask(CEPH_CAP_FILE_SHARED, true) &&
+      dn->cap_shared_gen == dir->shared_gen)
+    return true;
+  return _dentry_valid(dn);
+}
+
+/*
+ * Fill in the stx of pending names from a listing of dir.  READDIR replies
+ * carry the inode stats and dentry leases, so a single listing replaces one
+ * lookup/getattr round trip per name.
+ */
+int Client::_statx_many_readdir(Inode *dir,
+				std::map<string, std::vector<unsigned>>& pending,
+				struct ceph_statx *stx, int *results,
+				const UserPerm& perms, unsigned mask,
+				unsigned flags)
+{
+  ceph_assert(ceph_mutex_is_locked_by_me(client_lock));
+
+  dir_result_t *dirp;
+  int r = _opendir(dir, &dirp, perms);
+  if (r < 0)
+    return r;
+  // skip "." and ".."
+  dirp->offset = 2;
+
+  while (!pending.empty() && !dirp->at_end()) {
+    if (!dirp->is_cached()) {
+      r = _readdir_get_frag(CEPH_MDS_OP_READDIR, dirp, fill_readdir_args);
+      if (r < 0)
+	break;
+    }
+    frag_t fg = dirp->buffer_frag;
+
+    for (auto& entry : dirp->buffer) {
+      dirp->offset = entry.offset + 1;
+      auto p = pending.find(entry.name);
+      if (p == pending.end())
+	continue;
+      // leave trailing symlinks to be followed by path_walk()
+      if (entry.inode->is_symlink() && !(flags & AT_SYMLINK_NOFOLLOW))
+	continue;
+      for (auto i : p->second) {
+	fill_statx(entry.inode, mask, &stx[i]);
+	results[i] = 0;
+      }
+      pending.erase(p);
+      if (pending.empty())
+	break;
+    }
+
+    if (dirp->next_offset > 2) {
+      _readdir_drop_dirp_buffer(dirp);
+    } else if (!fg.is_rightmost()) {
+      _readdir_next_frag(dirp);
+    } else {
+      dirp->set_end();
+    }
+  }
+
+  _closedir(dirp);
+  return r;
+}
+
+/*
+ * Should the nr_pending uncached names of a statx_many call be looked up by
+ * listing dir?  A listing returns every entry of the directory, so it only
+ * wins over one lookup per name if the names are a large enough share of it.
+ */
+bool Client::_statx_many_use_readdir(Inode *dir, unsigned nr_pending)
+{
+  uint64_t readdir_min = cct->_conf->client_statx_many_readdir_min;
+  if (!readdir_min || nr_pending < readdir_min)
+    return false;
+
+  double ratio = cct->_conf->client_statx_many_readdir_ratio;
+  int64_t entries = dir->dirstat.size();
+  ldout(cct, 20) << __func__ << " " << *dir << " entries " << entries
+		 << " pending " << nr_pending << dendl;
+  return entries <= 0 || nr_pending >= ratio * entries;
+}
+
+int Client::statxat_many(int dirfd, const char * const *relpaths,
+			 unsigned count, struct ceph_statx *stx, int *results,
+			 const UserPerm& perms, unsigned int want,
+			 unsigned int flags)
+{
+  RWRef_t mref_reader(mount_state, CLIENT_MOUNTING);
+  if (!mref_reader.is_state_satisfied()) {
+    return -CEPHFS_ENOTCONN;
+  }
+
+  tout(cct) << __func__ << " flags " << hex << flags << " want " << want << dec << std::endl;
+  tout(cct) << dirfd << std::endl;
+  tout(cct) << count << std::endl;
+
+  unsigned mask = statx_to_mask(flags, want);
+
+  InodeRef dirinode;
+  std::scoped_lock lock(client_lock);
+  int r = get_fd_inode(dirfd, &dirinode);
+  if (r < 0) {
+    return r;
+  }
+
+  // plain names in this directory that would each need an MDS round trip
+  std::map<string, std::vector<unsigned>> pending;
+  if (dirinode->is_dir() && dirinode->snapid == CEPH_NOSNAP) {
+    for (unsigned i = 0; i < count; i++) {
+      string dname(relpaths[i]);
+      if (dname.empty() || dname == "." || dname == ".." ||
+	  dname.find('/') != string::npos ||
+	  dname == cct->_conf->client_snapdir) {
+	continue;
+      }
+      if (!_statx_cached(dirinode.get(), dname, mask)) {
+	pending[dname].push_back(i);
+      }
+    }
+  }
+
+  std::vector<bool> done(count, false);
+  unsigned nr_pending = pending.size();
+  unsigned nr_listed = 0;
+  if (_statx_many_use_readdir(dirinode.get(), nr_pending) &&
+      (!cct->_conf->client_permissions ||
+       (may_lookup(dirinode.get(), perms) == 0 &&
+	may_open(dirinode.get(), O_RDONLY, perms) == 0))) {
+    std::vector<unsigned> swept;
+    for (auto& p : pending) {
+      swept.insert(swept.end(), p.second.begin(), p.second.end());
+    }
+    r = _statx_many_readdir(dirinode.get(), pending, stx, results, perms,
+			    mask, flags);
+    if (r < 0) {
+      ldout(cct, 10) << __func__ << " readdir failed: " << r << dendl;
+    }
+    // names found by the listing are gone from pending
+    for (auto i : swept) {
+      if (!pending.count(relpaths[i])) {
+	done[i] = true;
+	nr_listed++;
+      }
+    }
+  }
+
+  // everything else takes the statxat() path: either it is answered from
+  // the cache, or it was not found by the listing and needs a lookup
+  for (unsigned i = 0; i < count; i++) {
+    if (done[i]) {
+      continue;
+    }
+    InodeRef in;
+    filepath path(relpaths[i]);
+    r = path_walk(path, &in, perms, !(flags & AT_SYMLINK_NOFOLLOW), mask,
+		  dirinode);
+    if (r == 0) {
+      r = _getattr(in, mask, perms);
+    }
+    if (r == 0) {
+      fill_statx(in, mask, &stx[i]);
+    }
+    results[i] = r;
+  }
+
+  ldout(cct, 3) << __func__ << " dirfd " << dirfd << " count " << count
+		<< " uncached " << nr_pending << " listed " << nr_listed << dendl;
+  return 0;
+}
+
 // not written yet, but i want to link!
 
 int Client::chdir(const char *relpath, std::string &new_cwd,
@@ -15766,9 +16011,16 @@ int Client::ll_write(Fh *fh, loff_t off, loff_t len, const char *data)
 
   /* We can't return bytes written larger than INT_MAX, clamp len to that */
   len = std::min(len, (loff_t)INT_MAX);
+
+  // copy the data before taking client_lock, for large writes this is
+  // most of the work and other files' I/O need not wait for it
+  bufferlist bl;
+  if (len > 0)
+    bl.append(data, len);
+
   std::scoped_lock lock(client_lock);
 
-  int r = _write(fh, off, len, data, NULL, 0);
+  int r = _write(fh, off, len, std::move(bl));
   ldout(cct, 3) << "ll_write " << fh << " " << off << "~" << len << " = " << r
 		<< dendl;
   return r;
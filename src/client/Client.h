@@ -493,6 +493,10 @@ public:
   int statxat(int dirfd, const char *relpath,
               struct ceph_statx *stx, const UserPerm& perms,
               unsigned int want, unsigned int flags);
+  int statxat_many(int dirfd, const char * const *relpaths, unsigned count,
+                   struct ceph_statx *stx, int *results,
+                   const UserPerm& perms, unsigned int want,
+                   unsigned int flags);
   int fallocate(int fd, int mode, loff_t offset, loff_t length);
 
   // full path xattr ops
@@ -946,6 +950,8 @@ protected:
   void resend_unsafe_requests(MetaSession *s);
   void wait_unsafe_requests();
 
+  bool _statx_many_use_readdir(Inode *dir, unsigned nr_pending);
+
   void dump_mds_requests(Formatter *f);
   void dump_mds_sessions(Formatter *f, bool cap_dump=false);
 
@@ -1514,6 +1520,7 @@ private:
 
     Client *client;
     Fh *f;
+    utime_t start;
   };
 
   /*
@@ -1577,6 +1584,11 @@ private:
     bool bypass_cache);
 
   void _closedir(dir_result_t *dirp);
+  bool _statx_cached(Inode *dir, const std::string& dname, int mask);
+  int _statx_many_readdir(Inode *dir,
+                          std::map<std::string, std::vector<unsigned>>& pending,
+                          struct ceph_statx *stx, int *results,
+                          const UserPerm& perms, unsigned mask, unsigned flags);
 
   // other helpers
   void _fragmap_remove_non_leaves(Inode *in);
@@ -1664,12 +1676,16 @@ private:
   loff_t _lseek(Fh *fh, loff_t offset, int whence);
   int64_t _read(Fh *fh, int64_t offset, uint64_t size, bufferlist *bl,
   		Context *onfinish = nullptr);
+  void adapt_readahead(Fh *f, uint64_t len);
   void do_readahead(Fh *f, Inode *in, uint64_t off, uint64_t len);
   int64_t _write_success(Fh *fh, utime_t start, uint64_t fpos,
           int64_t offset, uint64_t size, Inode *in);
   int64_t _write(Fh *fh, int64_t offset, uint64_t size, const char *buf,
           const struct iovec *iov, int iovcnt, Context *onfinish = nullptr,
           bool do_fsync = false, bool syncdataonly = false);
+  int64_t _write(Fh *fh, int64_t offset, uint64_t size, bufferlist&& bl,
+          Context *onfinish = nullptr, bool do_fsync = false,
+          bool syncdataonly = false);
   int64_t _preadv_pwritev_locked(Fh *fh, const struct iovec *iov,
                                  unsigned iovcnt, int64_t offset,
                                  bool write, bool clamp_to_int,
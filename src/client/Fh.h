@@ -30,6 +30,12 @@ struct Fh {
 
   Readahead readahead;
 
+  // adaptive readahead sizing (client_readahead_adaptive)
+  uint64_t readahead_max_bytes = 0; // configured upper bound
+  utime_t readahead_last_read;
+  double read_rate = 0;             // bytes/sec, ewma
+  double readahead_latency = 0;     // sec, ewma
+
   // file lock
   std::unique_ptr<ceph_lock_state_t> fcntl_locks;
   std::unique_ptr<ceph_lock_state_t> flock_locks;
@@ -1283,6 +1283,20 @@ static void do_init(void *data, fuse_conn_info *conn)
   if(conn->capable & FUSE_CAP_SPLICE_MOVE)
     conn->want |= FUSE_CAP_SPLICE_MOVE;
 
+  // Let the kernel read ahead in requests as large as the ones we accept;
+  // it clamps this to the readahead window of the mount.
+  auto fuse_max_readahead = client->cct->_conf.get_val<Option::size_t>(
+    "fuse_max_readahead");
+  if (fuse_max_readahead > 0)
+    conn->max_readahead = fuse_max_readahead;
+  lgeneric_subdout(client->cct, client, 1)
+    << "fuse_ll: do_init: max_write " << conn->max_write
+    << " max_readahead " << conn->max_readahead
+#if FUSE_VERSION >= FUSE_MAKE_VERSION(3, 0)
+    << " max_read " << conn->max_read
+#endif
+    << dendl;
+
 #if !defined(__APPLE__)
   if (!client->fuse_default_permissions && client->ll_handle_umask()) {
     // apply umask in userspace if posix acl is enabled
@@ -1420,7 +1434,7 @@ int CephFuse::Handle::init(int argc, const char *argv[])
 
   // set up fuse argc/argv
   int newargc = 0;
-  const char **newargv = (const char **) malloc((argc + 17) * sizeof(char *));
+  const char **newargv = (const char **) malloc((argc + 21) * sizeof(char *));
   if(!newargv)
     return ENOMEM;
 
@@ -1437,6 +1451,8 @@ int CephFuse::Handle::init(int argc, const char *argv[])
 #endif
   auto fuse_max_write = client->cct->_conf.get_val<Option::size_t>(
     "fuse_max_write");
+  auto fuse_max_read = client->cct->_conf.get_val<Option::size_t>(
+    "fuse_max_read");
   auto fuse_atomic_o_trunc = client->cct->_conf.get_val<bool>(
     "fuse_atomic_o_trunc");
   auto fuse_splice_read = client->cct->_conf.get_val<bool>(
@@ -1463,12 +1479,19 @@ int CephFuse::Handle::init(int argc, const char *argv[])
     newargv[newargc++] = "big_writes";
   }
 #endif
+  // referenced from newargv until the arguments are parsed
+  char strsplice[65];
+  char strmaxread[65];
   if (fuse_max_write > 0) {
-    char strsplice[65];
     newargv[newargc++] = "-o";
     sprintf(strsplice, "max_write=%zu", (size_t)fuse_max_write);
     newargv[newargc++] = strsplice;
   }
+  if (fuse_max_read > 0) {
+    newargv[newargc++] = "-o";
+    sprintf(strmaxread, "max_read=%zu", (size_t)fuse_max_read);
+    newargv[newargc++] = strmaxread;
+  }
   if (fuse_atomic_o_trunc) {
     newargv[newargc++] = "-o";
     newargv[newargc++] = "atomic_o_trunc";
@@ -8017,7 +8017,29 @@ int sparsify(cls_method_context_t hctx, bufferlist *in, bufferlist *out)
     return r;
   }
 
-  if (bl.is_zero()) {
+  // locate all sparse-size aligned data extents within a single pass
+  std::vector<std::pair<size_t, size_t>> data_extents;
+  size_t length = bl.length();
+  if (length > 0) {
+    if (!bl.is_contiguous()) {
+      bl.rebuild(ceph::buffer::ptr_node::create(length));
+    }
+
+    size_t write_offset = 0;
+    size_t write_length = 0;
+    size_t offset = 0;
+    const auto& ptr = bl.front();
+    while (offset < length) {
+      if (calc_sparse_extent(ptr, sparse_size, length, &write_offset,
+                             &write_length, &offset)) {
+        data_extents.emplace_back(write_offset, write_length);
+        write_offset = offset;
+        write_length = 0;
+      }
+    }
+  }
+
+  if (data_extents.empty()) {
     if (remove_empty) {
       CLS_LOG(20, "remove");
       r = cls_cxx_remove(hctx);
@@ -8025,7 +8047,7 @@ int sparsify(cls_method_context_t hctx, bufferlist *in, bufferlist *out)
         CLS_ERR("remove failed: %s", cpp_strerror(r).c_str());
         return r;
       }
-    } else if (bl.length() > 0) {
+    } else if (length > 0) {
       CLS_LOG(20, "truncate");
       bufferlist write_bl;
       r = cls_cxx_replace(hctx, 0, 0, &write_bl);
@@ -8039,37 +8061,29 @@ int sparsify(cls_method_context_t hctx, bufferlist *in, bufferlist *out)
     return 0;
   }
 
-  bl.rebuild(ceph::buffer::ptr_node::create(bl.length()));
-  size_t write_offset = 0;
-  size_t write_length = 0;
-  size_t offset = 0;
-  size_t length = bl.length();
+  if (data_extents.size() == 1 && data_extents.front().first == 0 &&
+      data_extents.front().second == length) {
+    CLS_LOG(20, "nothing to do");
+    return 0;
+  }
+
   const auto& ptr = bl.front();
   bool replace = true;
-  while (offset < length) {
-    if (calc_sparse_extent(ptr, sparse_size, length, &write_offset,
-                           &write_length, &offset)) {
-      if (write_offset == 0 && write_length == length) {
-        CLS_LOG(20, "nothing to do");
-        return 0;
-      }
-      CLS_LOG(20, "write%s %" PRIu64 "~%" PRIu64, (replace ? "(replace)" : ""),
-              write_offset, write_length);
-      bufferlist write_bl;
-      write_bl.push_back(ceph::buffer::ptr_node::create(ptr, write_offset,
-							write_length));
-      if (replace) {
-	r = cls_cxx_replace(hctx, write_offset, write_length, &write_bl);
-        replace = false;
-      } else {
-        r = cls_cxx_write(hctx, write_offset, write_length, &write_bl);
-      }
-      if (r < 0) {
-        CLS_ERR("write failed: %s", cpp_strerror(r).c_str());
-        return r;
-      }
-      write_offset = offset;
-      write_length = 0;
+  for (auto [write_offset, write_length] : data_extents) {
+    CLS_LOG(20, "write%s %" PRIu64 "~%" PRIu64, (replace ? "(replace)" : ""),
+            write_offset, write_length);
+    bufferlist write_bl;
+    write_bl.push_back(ceph::buffer::ptr_node::create(ptr, write_offset,
+                                                      write_length));
+    if (replace) {
+      r = cls_cxx_replace(hctx, write_offset, write_length, &write_bl);
+      replace = false;
+    } else {
+      r = cls_cxx_write(hctx, write_offset, write_length, &write_bl);
+    }
+    if (r < 0) {
+      CLS_ERR("write failed: %s", cpp_strerror(r).c_str());
+      return r;
     }
   }
 
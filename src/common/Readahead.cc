@@ -4,6 +4,8 @@
 #include "common/Readahead.h"
 #include "common/Cond.h"
 
+#include <algorithm>
+
 using std::vector;
 
 Readahead::Readahead()
@@ -11,12 +13,10 @@ Readahead::Readahead()
     m_readahead_min_bytes(0),
     m_readahead_max_bytes(NO_LIMIT),
     m_alignments(),
-    m_nr_consec_read(0),
-    m_consec_read_bytes(0),
-    m_last_pos(0),
-    m_readahead_pos(0),
-    m_readahead_trigger_pos(0),
-    m_readahead_size(0),
+    m_streams(1),
+    m_max_streams(1),
+    m_detect_patterns(false),
+    m_stamp(0),
     m_pending(0) {
 }
 
@@ -25,99 +25,262 @@ Readahead::~Readahead() {
 
 Readahead::extent_t Readahead::update(const vector<extent_t>& extents, uint64_t limit) {
   m_lock.lock();
+  stream_t *stream = nullptr;
   for (vector<extent_t>::const_iterator p = extents.begin(); p != extents.end(); ++p) {
-    _observe_read(p->first, p->second);
+    stream = &_observe_read(p->first, p->second);
   }
-  if (m_readahead_pos >= limit|| m_last_pos >= limit) {
+  if (!stream) {
     m_lock.unlock();
     return extent_t(0, 0);
   }
-  std::pair<uint64_t, uint64_t> extent = _compute_readahead(limit);
+  std::pair<uint64_t, uint64_t> extent = _update(*stream, limit);
   m_lock.unlock();
   return extent;
 }
 
 Readahead::extent_t Readahead::update(uint64_t offset, uint64_t length, uint64_t limit) {
   m_lock.lock();
-  _observe_read(offset, length);
-  if (m_readahead_pos >= limit || m_last_pos >= limit) {
-    m_lock.unlock();
-    return extent_t(0, 0);
-  }
-  extent_t extent = _compute_readahead(limit);
+  stream_t& stream = _observe_read(offset, length);
+  extent_t extent = _update(stream, limit);
   m_lock.unlock();
   return extent;
 }
 
-void Readahead::_observe_read(uint64_t offset, uint64_t length) {
-  if (offset == m_last_pos) {
-    m_nr_consec_read++;
-    m_consec_read_bytes += length;
-  } else {
-    m_nr_consec_read = 0;
-    m_consec_read_bytes = 0;
-    m_readahead_trigger_pos = 0;
-    m_readahead_size = 0;
-    m_readahead_pos = 0;
-  }
-  m_last_pos = offset + length;
-}
-
-Readahead::extent_t Readahead::_compute_readahead(uint64_t limit) {
-  uint64_t readahead_offset = 0;
-  uint64_t readahead_length = 0;
-  if (m_nr_consec_read >= m_trigger_requests) {
-    // currently reading sequentially
-    if (m_last_pos >= m_readahead_trigger_pos) {
-      // need to read ahead
-      if (m_readahead_size == 0) {
-	// initial readahead trigger
-	m_readahead_size = m_consec_read_bytes;
-	m_readahead_pos = m_last_pos;
-      } else {
-	// continuing readahead trigger
-	m_readahead_size *= 2;
-	if (m_last_pos > m_readahead_pos) {
-	  m_readahead_pos = m_last_pos;
-	}
+void Readahead::update(uint64_t offset, uint64_t length, uint64_t limit,
+		       vector<extent_t> *readahead) {
+  std::lock_guard lock(m_lock);
+  stream_t& stream = _observe_read(offset, length);
+  _compute_readahead(stream, limit, readahead);
+}
+
+Readahead::extent_t Readahead::_update(stream_t& stream, uint64_t limit) {
+  vector<extent_t> readahead;
+  _compute_readahead(stream, limit, &readahead);
+  if (readahead.empty()) {
+    return extent_t(0, 0);
+  }
+  // strided streams yield one extent per expected read; cover them all
+  uint64_t start = readahead.front().first;
+  uint64_t end = readahead.back().first + readahead.back().second;
+  return extent_t(start, end - start);
+}
+
+Readahead::stream_t& Readahead::_observe_read(uint64_t offset, uint64_t length) {
+  ++m_stamp;
+
+  // forward sequential reads first, they are by far the most common
+  for (auto& stream : m_streams) {
+    if (offset == stream.last_pos &&
+	stream.pattern != PATTERN_REVERSE &&
+	stream.pattern != PATTERN_STRIDED) {
+      stream.pattern = PATTERN_SEQUENTIAL;
+      stream.nr_consec_read++;
+      stream.consec_read_bytes += length;
+      stream.last_offset = offset;
+      stream.last_pos = offset + length;
+      stream.stamp = m_stamp;
+      return stream;
+    }
+  }
+
+  if (m_detect_patterns) {
+    for (auto& stream : m_streams) {
+      if (stream.stamp == 0) {
+	// the initial stream has not seen a read yet
+	continue;
       }
-      m_readahead_size = std::max(m_readahead_size, m_readahead_min_bytes);
-      m_readahead_size = std::min(m_readahead_size, m_readahead_max_bytes);
-      readahead_offset = m_readahead_pos;
-      readahead_length = m_readahead_size;
-
-      // Snap to the first alignment possible
-      uint64_t readahead_end = readahead_offset + readahead_length;
-      for (vector<uint64_t>::iterator p = m_alignments.begin(); p != m_alignments.end(); ++p) {
-	// Align the readahead, if possible.
-	uint64_t alignment = *p;
-	uint64_t align_prev = readahead_end / alignment * alignment;
-	uint64_t align_next = align_prev + alignment;
-	uint64_t dist_prev = readahead_end - align_prev;
-	uint64_t dist_next = align_next - readahead_end;
-	if (dist_prev < readahead_length / 2 && dist_prev < dist_next) {
-	  // we can snap to the previous alignment point by a less than 50% reduction in size
-	  ceph_assert(align_prev > readahead_offset);
-	  readahead_length = align_prev - readahead_offset;
-	  break;
-	} else if(dist_next < readahead_length / 2) {
-	  // we can snap to the next alignment point by a less than 50% increase in size
-	  ceph_assert(align_next > readahead_offset);
-	  readahead_length = align_next - readahead_offset;
-	  break;
-	}
-	// Note that m_readahead_size should remain unadjusted.
+      bool match = false;
+      if (offset + length == stream.last_offset &&
+	  (stream.pattern == PATTERN_NONE ||
+	   stream.pattern == PATTERN_REVERSE)) {
+	stream.pattern = PATTERN_REVERSE;
+	match = true;
+      } else if (offset > stream.last_pos &&
+		 stream.pattern == PATTERN_STRIDED &&
+		 offset - stream.last_offset == stream.stride) {
+	match = true;
+      } else if (offset > stream.last_pos &&
+		 stream.pattern == PATTERN_NONE) {
+	stream.pattern = PATTERN_STRIDED;
+	stream.stride = offset - stream.last_offset;
+	match = true;
       }
-
-      if (m_readahead_pos + readahead_length > limit) {
-	readahead_length = limit - m_readahead_pos;
+      if (match) {
+	stream.nr_consec_read++;
+	stream.consec_read_bytes += length;
+	stream.last_offset = offset;
+	stream.last_pos = offset + length;
+	stream.stamp = m_stamp;
+	return stream;
       }
+    }
+  }
+
+  // start a new stream, replacing the least recently used one if needed
+  stream_t *stream;
+  if (m_streams.size() < m_max_streams) {
+    stream = &m_streams.emplace_back();
+  } else {
+    stream = &*std::min_element(
+      m_streams.begin(), m_streams.end(),
+      [](const stream_t& a, const stream_t& b) { return a.stamp < b.stamp; });
+    *stream = stream_t();
+  }
+  stream->last_offset = offset;
+  stream->last_pos = offset + length;
+  stream->stamp = m_stamp;
+  return *stream;
+}
+
+void Readahead::_compute_readahead(stream_t& stream, uint64_t limit,
+				   vector<extent_t> *readahead) {
+  if (stream.nr_consec_read < m_trigger_requests) {
+    return;
+  }
+  switch (stream.pattern) {
+  case PATTERN_SEQUENTIAL:
+    _compute_sequential(stream, limit, readahead);
+    break;
+  case PATTERN_REVERSE:
+    _compute_reverse(stream, limit, readahead);
+    break;
+  case PATTERN_STRIDED:
+    _compute_strided(stream, limit, readahead);
+    break;
+  default:
+    break;
+  }
+}
+
+void Readahead::_compute_sequential(stream_t& stream, uint64_t limit,
+				    vector<extent_t> *readahead) {
+  if (stream.readahead_pos >= limit || stream.last_pos >= limit) {
+    return;
+  }
+  if (stream.last_pos < stream.readahead_trigger_pos) {
+    return;
+  }
+
+  // need to read ahead
+  if (stream.readahead_size == 0) {
+    // initial readahead trigger
+    stream.readahead_size = stream.consec_read_bytes;
+    stream.readahead_pos = stream.last_pos;
+  } else {
+    // continuing readahead trigger
+    stream.readahead_size *= 2;
+    if (stream.last_pos > stream.readahead_pos) {
+      stream.readahead_pos = stream.last_pos;
+    }
+  }
+  stream.readahead_size = std::max(stream.readahead_size, m_readahead_min_bytes);
+  stream.readahead_size = std::min(stream.readahead_size, m_readahead_max_bytes);
+  uint64_t readahead_offset = stream.readahead_pos;
+  uint64_t readahead_length = stream.readahead_size;
 
-      m_readahead_trigger_pos = m_readahead_pos + readahead_length / 2;
-      m_readahead_pos += readahead_length;
+  // Snap to the first alignment possible
+  uint64_t readahead_end = readahead_offset + readahead_length;
+  for (vector<uint64_t>::iterator p = m_alignments.begin(); p != m_alignments.end(); ++p) {
+    // Align the readahead, if possible.
+    uint64_t alignment = *p;
+    uint64_t align_prev = readahead_end / alignment * alignment;
+    uint64_t align_next = align_prev + alignment;
+    uint64_t dist_prev = readahead_end - align_prev;
+    uint64_t dist_next = align_next - readahead_end;
+    if (dist_prev < readahead_length / 2 && dist_prev < dist_next) {
+      // we can snap to the previous alignment point by a less than 50% reduction in size
+      ceph_assert(align_prev > readahead_offset);
+      readahead_length = align_prev - readahead_offset;
+      break;
+    } else if(dist_next < readahead_length / 2) {
+      // we can snap to the next alignment point by a less than 50% increase in size
+      ceph_assert(align_next > readahead_offset);
+      readahead_length = align_next - readahead_offset;
+      break;
     }
+    // Note that readahead_size should remain unadjusted.
   }
-  return extent_t(readahead_offset, readahead_length);
+
+  if (stream.readahead_pos + readahead_length > limit) {
+    readahead_length = limit - stream.readahead_pos;
+  }
+
+  stream.readahead_trigger_pos = stream.readahead_pos + readahead_length / 2;
+  stream.readahead_pos += readahead_length;
+  readahead->push_back(extent_t(readahead_offset, readahead_length));
+}
+
+void Readahead::_compute_reverse(stream_t& stream, uint64_t limit,
+				 vector<extent_t> *readahead) {
+  if (stream.last_pos > limit) {
+    return;
+  }
+  if (stream.readahead_size != 0 &&
+      stream.last_offset > stream.readahead_trigger_pos) {
+    return;
+  }
+
+  // readahead_pos is the start of the data read ahead so far
+  if (stream.readahead_size == 0) {
+    stream.readahead_size = stream.consec_read_bytes;
+    stream.readahead_pos = stream.last_offset;
+  } else {
+    stream.readahead_size *= 2;
+    if (stream.last_offset < stream.readahead_pos) {
+      stream.readahead_pos = stream.last_offset;
+    }
+  }
+  stream.readahead_size = std::max(stream.readahead_size, m_readahead_min_bytes);
+  stream.readahead_size = std::min(stream.readahead_size, m_readahead_max_bytes);
+
+  uint64_t readahead_length = std::min(stream.readahead_size,
+				       stream.readahead_pos);
+  if (readahead_length == 0) {
+    return;
+  }
+  uint64_t readahead_offset = stream.readahead_pos - readahead_length;
+  stream.readahead_trigger_pos = readahead_offset + readahead_length / 2;
+  stream.readahead_pos = readahead_offset;
+  readahead->push_back(extent_t(readahead_offset, readahead_length));
+}
+
+void Readahead::_compute_strided(stream_t& stream, uint64_t limit,
+				 vector<extent_t> *readahead) {
+  uint64_t next_offset = stream.last_offset + stream.stride;
+  if (next_offset >= limit) {
+    return;
+  }
+  if (stream.last_pos < stream.readahead_trigger_pos) {
+    return;
+  }
+
+  // readahead_pos is the offset of the next expected read not yet read ahead
+  if (stream.readahead_size == 0) {
+    stream.readahead_size = stream.consec_read_bytes;
+    stream.readahead_pos = next_offset;
+  } else {
+    stream.readahead_size *= 2;
+    if (next_offset > stream.readahead_pos) {
+      stream.readahead_pos = next_offset;
+    }
+  }
+  stream.readahead_size = std::max(stream.readahead_size, m_readahead_min_bytes);
+  stream.readahead_size = std::min(stream.readahead_size, m_readahead_max_bytes);
+
+  // only fetch what the expected reads will touch, not the gaps
+  uint64_t length = stream.last_pos - stream.last_offset;
+  uint64_t count = std::max<uint64_t>(1, stream.readahead_size / length);
+  uint64_t offset = stream.readahead_pos;
+  uint64_t emitted = 0;
+  for (; emitted < count && offset < limit; ++emitted, offset += stream.stride) {
+    readahead->push_back(extent_t(offset, std::min(length, limit - offset)));
+  }
+  if (emitted == 0) {
+    return;
+  }
+  stream.readahead_trigger_pos = stream.readahead_pos +
+    (emitted / 2) * stream.stride;
+  stream.readahead_pos = offset;
 }
 
 void Readahead::inc_pending(int count) {
@@ -189,6 +352,21 @@ void Readahead::set_max_readahead_size(uint64_t max_readahead_size) {
   m_lock.unlock();
 }
 
+void Readahead::set_max_streams(unsigned max_streams) {
+  std::lock_guard lock(m_lock);
+  m_max_streams = std::max(1u, max_streams);
+  while (m_streams.size() > m_max_streams) {
+    m_streams.erase(std::min_element(
+      m_streams.begin(), m_streams.end(),
+      [](const stream_t& a, const stream_t& b) { return a.stamp < b.stamp; }));
+  }
+}
+
+void Readahead::set_detect_patterns(bool detect_patterns) {
+  std::lock_guard lock(m_lock);
+  m_detect_patterns = detect_patterns;
+}
+
 void Readahead::set_alignments(const vector<uint64_t> &alignments) {
   m_lock.lock();
   m_alignments = alignments;
@@ -58,6 +58,20 @@ public:
    */
   extent_t update(uint64_t offset, uint64_t length, uint64_t limit);
 
+  /**
+     Update state with a new read and append the readahead to be performed
+     to \c readahead.
+     A strided stream may yield several extents, one per expected read; the
+     single extent variants above return the span covering them instead.
+
+     @param offset offset of the read operation
+     @param length length of the read operation
+     @param limit size of the thing readahead is being applied to
+     @param readahead readahead extents to perform
+   */
+  void update(uint64_t offset, uint64_t length, uint64_t limit,
+	      std::vector<extent_t> *readahead);
+
   /**
      Increment the pending counter.
    */
@@ -100,6 +114,18 @@ public:
    */
   void set_max_readahead_size(uint64_t max_readahead_size);
 
+  /**
+     Sets the number of independent read streams tracked, so that
+     interleaved sequential reads each get their readahead. Defaults to 1.
+   */
+  void set_max_streams(unsigned max_streams);
+
+  /**
+     Enables the detection of reverse sequential and strided (constant gap)
+     streams in addition to forward sequential ones.
+   */
+  void set_detect_patterns(bool detect_patterns);
+
   /**
      Sets the alignment units.
      If the end point of a readahead request can be aligned to an alignment unit
@@ -109,17 +135,65 @@ public:
   void set_alignments(const std::vector<uint64_t> &alignments);
 
 private:
+  enum pattern_t {
+    PATTERN_NONE,
+    PATTERN_SEQUENTIAL,
+    PATTERN_REVERSE,
+    PATTERN_STRIDED,
+  };
+
+  struct stream_t {
+    pattern_t pattern = PATTERN_NONE;
+
+    /// Number of consecutive read requests in the stream
+    int nr_consec_read = 0;
+
+    /// Number of bytes read in the stream
+    uint64_t consec_read_bytes = 0;
+
+    /// Offset of the last read of the stream
+    uint64_t last_offset = 0;
+
+    /// Position of the read stream (end of the last read)
+    uint64_t last_pos = 0;
+
+    /// Distance between the offsets of consecutive reads of a strided stream
+    uint64_t stride = 0;
+
+    /// Position of the readahead stream: its end for forward streams, its
+    /// start for reverse ones
+    uint64_t readahead_pos = 0;
+
+    /// When readahead is already triggered and the read stream crosses this point, readahead is continued
+    uint64_t readahead_trigger_pos = 0;
+
+    /// Size of the next readahead request (barring changes due to alignment, etc.)
+    uint64_t readahead_size = 0;
+
+    /// Last use, for replacing the least recently used stream
+    uint64_t stamp = 0;
+  };
+
   /**
      Records that a read request has been received.
      m_lock must be held while calling.
+     @returns the stream the read belongs to
    */
-  void _observe_read(uint64_t offset, uint64_t length);
+  stream_t& _observe_read(uint64_t offset, uint64_t length);
 
   /**
-     Computes the next readahead request.
+     Computes the next readahead request(s) of a stream.
      m_lock must be held while calling.
   */
-  extent_t _compute_readahead(uint64_t limit);
+  void _compute_readahead(stream_t& stream, uint64_t limit,
+			  std::vector<extent_t> *readahead);
+  void _compute_sequential(stream_t& stream, uint64_t limit,
+			   std::vector<extent_t> *readahead);
+  void _compute_reverse(stream_t& stream, uint64_t limit,
+			std::vector<extent_t> *readahead);
+  void _compute_strided(stream_t& stream, uint64_t limit,
+			std::vector<extent_t> *readahead);
+  extent_t _update(stream_t& stream, uint64_t limit);
 
   /// Number of sequential requests necessary to trigger readahead
   int m_trigger_requests;
@@ -136,23 +210,17 @@ private:
   /// Held while reading/modifying any state except m_pending
   ceph::mutex m_lock = ceph::make_mutex("Readahead::m_lock");
 
-  /// Number of consecutive read requests in the current sequential stream
-  int m_nr_consec_read;
-
-  /// Number of bytes read in the current sequenial stream
-  uint64_t m_consec_read_bytes;
-
-  /// Position of the read stream
-  uint64_t m_last_pos;
+  /// Tracked read streams, most recently used one last touched
+  std::vector<stream_t> m_streams;
 
-  /// Position of the readahead stream
-  uint64_t m_readahead_pos;
+  /// Maximum number of tracked read streams
+  unsigned m_max_streams;
 
-  /// When readahead is already triggered and the read stream crosses this point, readahead is continued
-  uint64_t m_readahead_trigger_pos;
+  /// Whether reverse and strided streams are detected
+  bool m_detect_patterns;
 
-  /// Size of the next readahead request (barring changes due to alignment, etc.)
-  uint64_t m_readahead_size;
+  /// Counter stamping stream use
+  uint64_t m_stamp;
 
   /// Number of pending readahead requests, as determined by inc_pending() and dec_pending()
   int m_pending;
@@ -14,6 +14,7 @@
 #include "common/Formatter.h"
 #include "include/ceph_assert.h"
 #include "include/encoding.h"
+#include <cstring>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -188,6 +189,24 @@ public:
   Reference operator[](uint64_t offset);
   ConstReference operator[](uint64_t offset) const;
 
+  // word-at-a-time helpers: every 64-bit word of packed data holds
+  // 64 / _bit_count elements, so bulk scans and updates avoid the
+  // per-element iterator overhead
+  static uint64_t word_pattern(uint8_t value) {
+    return (~0ULL / MASK) * (value & MASK);
+  }
+  uint64_t find_first_not_of(uint8_t value, uint64_t offset) const;
+  void set_range(uint64_t offset, uint64_t length, uint8_t value);
+
+  // apply f to the packed words holding elements [offset, offset + length):
+  // f(word) or f(word, other_word) must operate on each element lane
+  // independently (e.g. bitwise logic against word_pattern() constants)
+  template <typename F>
+  void transform(uint64_t offset, uint64_t length, F&& f);
+  template <typename F>
+  void transform(const BitVector& other, uint64_t offset, uint64_t length,
+                 F&& f);
+
   void encode_header(bufferlist& bl) const;
   void decode_header(bufferlist::const_iterator& it);
   uint64_t get_header_length() const;
@@ -240,6 +259,11 @@ private:
 
   static void compute_index(uint64_t offset, uint64_t *index, uint64_t *shift);
 
+  static uint8_t byte_mask(uint64_t begin, uint64_t end);
+  template <typename F>
+  void transform_bytes(const bufferlist* other_data, uint64_t offset,
+                       uint64_t length, F&& f);
+
 };
 
 template <uint8_t _b>
@@ -299,6 +323,167 @@ void BitVector<_b>::compute_index(uint64_t offset, uint64_t *index, uint64_t *sh
   *shift = ((ELEMENTS_PER_BLOCK - 1) - (offset % ELEMENTS_PER_BLOCK)) * _b;
 }
 
+template <uint8_t _b>
+uint8_t BitVector<_b>::byte_mask(uint64_t begin, uint64_t end) {
+  // mask of the bits within a byte holding elements [begin, end)
+  return static_cast<uint8_t>((0xFF >> (begin * _b)) &
+                              ~(0xFF >> (end * _b)));
+}
+
+template <uint8_t _b>
+uint64_t BitVector<_b>::find_first_not_of(uint8_t value,
+                                          uint64_t offset) const {
+  if (offset >= m_size) {
+    return m_size;
+  }
+
+  // scan the leading partial byte element by element
+  for (; offset < m_size && offset % ELEMENTS_PER_BLOCK != 0; ++offset) {
+    if ((*this)[offset] != value) {
+      return offset;
+    }
+  }
+
+  const uint64_t pattern = word_pattern(value);
+  uint64_t byte_offset = offset / ELEMENTS_PER_BLOCK;
+  uint64_t byte_end = m_size / ELEMENTS_PER_BLOCK;
+  if (byte_offset < byte_end) {
+    auto it = m_data.begin(byte_offset);
+    while (byte_offset < byte_end) {
+      const char *data;
+      size_t len = it.get_ptr_and_advance(byte_end - byte_offset, &data);
+      size_t pos = 0;
+      for (; pos + sizeof(uint64_t) <= len; pos += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, data + pos, sizeof(word));
+        if (word != pattern) {
+          break;
+        }
+      }
+      for (; pos < len; ++pos) {
+        if (static_cast<uint8_t>(data[pos]) != static_cast<uint8_t>(pattern)) {
+          offset = (byte_offset + pos) * ELEMENTS_PER_BLOCK;
+          for (;; ++offset) {
+            if ((*this)[offset] != value) {
+              return offset;
+            }
+          }
+        }
+      }
+      byte_offset += len;
+    }
+    offset = byte_end * ELEMENTS_PER_BLOCK;
+  }
+
+  // scan the trailing partial byte element by element
+  for (; offset < m_size; ++offset) {
+    if ((*this)[offset] != value) {
+      return offset;
+    }
+  }
+  return m_size;
+}
+
+template <uint8_t _b>
+void BitVector<_b>::set_range(uint64_t offset, uint64_t length,
+                              uint8_t value) {
+  const uint64_t pattern = word_pattern(value);
+  transform(offset, length, [pattern](uint64_t) { return pattern; });
+}
+
+template <uint8_t _b>
+template <typename F>
+void BitVector<_b>::transform(uint64_t offset, uint64_t length, F&& f) {
+  transform_bytes(nullptr, offset, length,
+                  [&f](uint64_t word, uint64_t) { return f(word); });
+}
+
+template <uint8_t _b>
+template <typename F>
+void BitVector<_b>::transform(const BitVector& other, uint64_t offset,
+                              uint64_t length, F&& f) {
+  ceph_assert(offset + length <= other.m_size);
+  transform_bytes(&other.m_data, offset, length, std::forward<F>(f));
+}
+
+template <uint8_t _b>
+template <typename F>
+void BitVector<_b>::transform_bytes(const bufferlist* other_data,
+                                    uint64_t offset, uint64_t length, F&& f) {
+  ceph_assert(offset + length <= m_size);
+  if (length == 0) {
+    return;
+  }
+
+  uint64_t end_offset = offset + length;
+  uint64_t byte_begin = offset / ELEMENTS_PER_BLOCK;
+  uint64_t byte_end = (end_offset + ELEMENTS_PER_BLOCK - 1) /
+                        ELEMENTS_PER_BLOCK;
+  uint8_t first_mask = byte_mask(offset % ELEMENTS_PER_BLOCK,
+                                 ELEMENTS_PER_BLOCK);
+  uint8_t last_mask = byte_mask(
+    0, end_offset - (byte_end - 1) * ELEMENTS_PER_BLOCK);
+
+  // any shared or fragmented buffers are rebuilt once so that the packed
+  // data can be updated in place
+  char *data = m_data.c_str();
+  bufferlist::const_iterator other_it;
+  if (other_data != nullptr) {
+    other_it = other_data->begin(byte_begin);
+  }
+
+  auto transform_byte = [&f, data](uint64_t byte_offset, uint8_t other,
+                                   uint8_t mask) {
+    uint8_t v = static_cast<uint8_t>(data[byte_offset]);
+    uint8_t r = static_cast<uint8_t>(f(v, other));
+    data[byte_offset] = static_cast<char>((v & ~mask) | (r & mask));
+  };
+
+  uint64_t byte_offset = byte_begin;
+  while (byte_offset < byte_end) {
+    const char *other_ptr = nullptr;
+    size_t len = byte_end - byte_offset;
+    if (other_data != nullptr) {
+      len = other_it.get_ptr_and_advance(len, &other_ptr);
+    }
+
+    size_t pos = 0;
+    while (pos < len) {
+      uint64_t cur = byte_offset + pos;
+      if (cur == byte_begin || cur == byte_end - 1 ||
+          pos + sizeof(uint64_t) > len ||
+          cur + sizeof(uint64_t) > byte_end - 1) {
+        uint8_t mask = 0xFF;
+        if (cur == byte_begin) {
+          mask &= first_mask;
+        }
+        if (cur == byte_end - 1) {
+          mask &= last_mask;
+        }
+        transform_byte(cur, other_ptr != nullptr ?
+                              static_cast<uint8_t>(other_ptr[pos]) : 0, mask);
+        ++pos;
+        continue;
+      }
+
+      uint64_t word;
+      uint64_t other_word = 0;
+      memcpy(&word, data + cur, sizeof(word));
+      if (other_ptr != nullptr) {
+        memcpy(&other_word, other_ptr + pos, sizeof(other_word));
+      }
+      word = f(word, other_word);
+      memcpy(data + cur, &word, sizeof(word));
+      pos += sizeof(uint64_t);
+    }
+    byte_offset += len;
+  }
+
+  // the raw buffers were modified behind the bufferlist's back, drop any
+  // crc cached by decode_data()
+  m_data.invalidate_crc();
+}
+
 template <uint8_t _b>
 void BitVector<_b>::encode_header(bufferlist& bl) const {
   bufferlist header_bl;
@@ -943,6 +943,29 @@ int ceph_fstatx(struct ceph_mount_info *cmount, int fd, struct ceph_statx *stx,
 int ceph_statxat(struct ceph_mount_info *cmount, int dirfd, const char *relpath,
                  struct ceph_statx *stx, unsigned int want, unsigned int flags);
 
+/**
+ * Get attributes of many files relative to a file descriptor
+ *
+ * Equivalent to calling ceph_statxat() on each of the paths, except that
+ * when the names that are not cached make up a large share of the directory,
+ * the directory is listed instead of looking each one up with the MDS.
+ *
+ * @param cmount the ceph mount handle to use for performing the stat.
+ * @param dirfd open file descriptor (or CEPHFS_AT_FDCWD)
+ * @param relpaths array of count paths to get statistics of
+ * @param count number of paths
+ * @param stx array of count ceph_statx structs to be filled in
+ * @param results array of count ints filled in with the result of each stat:
+ *        0 on success, negative error code on failure
+ * @param want bitfield of CEPH_STATX_* flags showing designed attributes
+ * @param flags bitfield that can be used to set AT_* modifier flags (AT_STATX_SYNC_AS_STAT, AT_STATX_FORCE_SYNC, AT_STATX_DONT_SYNC and AT_SYMLINK_NOFOLLOW)
+ * @returns 0 on success or negative error code if no stat was attempted.
+ */
+int ceph_statx_many(struct ceph_mount_info *cmount, int dirfd,
+		    const char * const *relpaths, unsigned count,
+		    struct ceph_statx *stx, int *results,
+		    unsigned int want, unsigned int flags);
+
 /**
  * Get a file's extended statistics and attributes.
  *
@@ -65,6 +65,13 @@ void ObjectRecorder::set_append_batch_options(int flush_interval,
   m_flush_age = flush_age;
 }
 
+void ObjectRecorder::set_group_commit(bool group_commit) {
+  ldout(m_cct, 5) << "group_commit=" << group_commit << dendl;
+
+  ceph_assert(ceph_mutex_is_locked(*m_lock));
+  m_group_commit = group_commit;
+}
+
 bool ObjectRecorder::append(AppendBuffers &&append_buffers) {
   ldout(m_cct, 20) << "count=" << append_buffers.size() << dendl;
 
@@ -151,6 +158,10 @@ void ObjectRecorder::claim_append_buffers(AppendBuffers *append_buffers) {
   ceph_assert(m_in_flight_appends.empty());
   ceph_assert(m_object_closed || m_overflowed);
 
+  // the flush request is re-issued when the future is attached to the
+  // new object recorder
+  m_flush_deferred = false;
+
   for (auto& append_buffer : m_pending_buffers) {
     ldout(m_cct, 20) << "detached " << *append_buffer.first << dendl;
     append_buffer.first->detach();
@@ -227,9 +238,13 @@ void ObjectRecorder::handle_append_flushed(uint64_t tid, int r) {
     append_buffer.first->safe(r);
   }
 
-  // attempt to kick off more appends to the object
+  // attempt to kick off more appends to the object -- including all the
+  // flush requests which were coalesced while this append was in-flight
   locker.lock();
-  if (!m_object_closed && !m_overflowed && send_appends(false, {})) {
+  bool flush_deferred = false;
+  std::swap(flush_deferred, m_flush_deferred);
+  if (!m_object_closed && !m_overflowed &&
+      send_appends(flush_deferred, {})) {
     notify_overflowed = true;
   }
 
@@ -278,6 +293,10 @@ bool ObjectRecorder::send_appends(bool force, ceph::ref_t<FutureImpl> flush_futu
     return false;
   }
 
+  if (force && flush_future && defer_flush(flush_future)) {
+    return false;
+  }
+
   if (!force &&
       ((m_flush_interval > 0 && m_pending_buffers.size() >= m_flush_interval) ||
        (m_flush_bytes > 0 && m_pending_bytes >= m_flush_bytes) ||
@@ -379,6 +398,29 @@ bool ObjectRecorder::send_appends(bool force, ceph::ref_t<FutureImpl> flush_futu
   return m_overflowed;
 }
 
+bool ObjectRecorder::defer_flush(const ceph::ref_t<FutureImpl>& flush_future) {
+  ceph_assert(ceph_mutex_is_locked(*m_lock));
+  if (!m_group_commit) {
+    return false;
+  }
+
+  // group commit: instead of issuing a dedicated append for each flush
+  // request, piggyback on the completion of the in-flight appends so that
+  // all entries flushed in the meantime are sent as a single append. The
+  // added latency is bounded by the round-trip of the in-flight appends
+  // and the flush byte threshold.
+  int32_t max_in_flight_appends = std::max(m_max_in_flight_appends, 1);
+  if (static_cast<int32_t>(m_in_flight_tids.size()) < max_in_flight_appends) {
+    return false;
+  } else if (m_flush_bytes > 0 && m_pending_bytes >= m_flush_bytes) {
+    return false;
+  }
+
+  ldout(m_cct, 20) << "deferring flush of " << *flush_future << dendl;
+  m_flush_deferred = true;
+  return true;
+}
+
 void ObjectRecorder::wake_up_flushes() {
   ceph_assert(ceph_mutex_is_locked(*m_lock));
   --m_in_flight_callbacks;
@@ -36,6 +36,7 @@ public:
 
   void set_append_batch_options(int flush_interval, uint64_t flush_bytes,
                                 double flush_age);
+  void set_group_commit(bool group_commit);
 
   inline uint64_t get_object_number() const {
     return m_object_number;
@@ -110,6 +111,7 @@ private:
   uint64_t m_flush_bytes = 0;
   double m_flush_age = 0;
   int32_t m_max_in_flight_appends;
+  bool m_group_commit = false;
 
   bool m_compat_mode;
 
@@ -128,6 +130,7 @@ private:
   AppendBuffers m_pending_buffers;
   uint64_t m_pending_bytes = 0;
   utime_t m_last_flush_time;
+  bool m_flush_deferred = false;
 
   uint64_t m_append_tid = 0;
 
@@ -147,6 +150,7 @@ private:
   uint64_t m_in_flight_bytes = 0;
 
   bool send_appends(bool force, ceph::ref_t<FutureImpl> flush_sentinel);
+  bool defer_flush(const ceph::ref_t<FutureImpl>& flush_future);
   void handle_append_flushed(uint64_t tid, int r);
   void append_overflowed();
 
@@ -12,6 +12,7 @@ struct Settings {
   double commit_interval = 5;         ///< commit position throttle (in secs)
   uint64_t max_payload_bytes = 0;     ///< 0 implies object size limit
   int max_concurrent_object_sets = 0; ///< 0 implies no limit
+  bool group_commit = false;          ///< coalesce flushes w/ in-flight appends
   std::set<std::string> ignored_laggy_clients;
                                       ///< clients that mustn't be disconnected
 };
@@ -988,6 +988,20 @@ extern "C" int ceph_statxat(struct ceph_mount_info *cmount, int dirfd, const cha
                                        want, flags);
 }
 
+extern "C" int ceph_statx_many(struct ceph_mount_info *cmount, int dirfd,
+				const char * const *relpaths, unsigned count,
+				struct ceph_statx *stx, int *results,
+				unsigned int want, unsigned int flags)
+{
+  if (!cmount->is_mounted())
+    return -CEPHFS_ENOTCONN;
+  if (flags & ~CEPH_REQ_FLAG_MASK)
+    return -CEPHFS_EINVAL;
+  return cmount->get_client()->statxat_many(dirfd, relpaths, count, stx,
+					    results, cmount->default_perms,
+					    want, flags);
+}
+
 extern "C" int ceph_statx(struct ceph_mount_info *cmount, const char *path,
 			  struct ceph_statx *stx, unsigned int want, unsigned int flags)
 {
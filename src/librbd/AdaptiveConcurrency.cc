@@ -0,0 +1,60 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#include "librbd/AdaptiveConcurrency.h"
+#include <algorithm>
+
+namespace librbd {
+
+void AdaptiveConcurrency::reset(uint64_t initial, uint64_t limit) {
+  m_concurrency = initial;
+  m_limit = limit;
+  if (m_limit > 0) {
+    m_concurrency = std::min(m_concurrency, m_limit);
+  }
+  m_window_completions = 0;
+  m_min_latency.reset();
+  m_avg_latency = ceph::timespan::zero();
+}
+
+bool AdaptiveConcurrency::update(const ceph::timespan& latency) {
+  if (m_limit == 0 || latency <= ceph::timespan::zero()) {
+    // a zero sample (e.g. a clock too coarse for the op) would pin the
+    // minimum latency and keep backing off forever
+    return false;
+  }
+
+  if (!m_min_latency || latency < *m_min_latency) {
+    m_min_latency = latency;
+  }
+  if (m_avg_latency == ceph::timespan::zero()) {
+    m_avg_latency = latency;
+  } else {
+    // exponentially weighted moving average w/ alpha = 1/8
+    m_avg_latency = (m_avg_latency * 7 + latency) / 8;
+  }
+
+  if (++m_window_completions < m_concurrency) {
+    return false;
+  }
+  m_window_completions = 0;
+
+  uint64_t concurrency = m_concurrency;
+  if (m_avg_latency > *m_min_latency * 2) {
+    concurrency = std::max<uint64_t>(1, (m_concurrency * 3) / 4);
+  } else if (m_concurrency < m_limit) {
+    ++concurrency;
+  }
+
+  // let the minimum drift up so that a single lucky sample (or a change in
+  // the cluster's baseline latency) doesn't pin it forever
+  *m_min_latency = *m_min_latency * 105 / 100;
+
+  if (concurrency == m_concurrency) {
+    return false;
+  }
+  m_concurrency = concurrency;
+  return true;
+}
+
+} // namespace librbd
@@ -0,0 +1,57 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#ifndef CEPH_LIBRBD_ADAPTIVE_CONCURRENCY_H
+#define CEPH_LIBRBD_ADAPTIVE_CONCURRENCY_H
+
+#include "include/int_types.h"
+#include "common/ceph_time.h"
+#include <optional>
+
+namespace librbd {
+
+/**
+ * Adapts the number of concurrent ops issued by a request to the latency
+ * the cluster delivers: once per window of completed ops, back off when
+ * the average latency grows past twice the lowest seen (the OSDs are
+ * queueing) and probe one op higher otherwise, up to the limit. The lowest
+ * latency drifts up by 5% per window so that it tracks the current baseline.
+ *
+ * Not thread-safe: callers serialize access with their own lock.
+ */
+class AdaptiveConcurrency {
+public:
+  /**
+   * Start at min(initial, limit) concurrent ops. A zero limit disables the
+   * adaptation and keeps the concurrency at initial.
+   */
+  void reset(uint64_t initial, uint64_t limit);
+
+  uint64_t get() const {
+    return m_concurrency;
+  }
+  ceph::timespan get_avg_latency() const {
+    return m_avg_latency;
+  }
+  ceph::timespan get_min_latency() const {
+    return m_min_latency.value_or(ceph::timespan::zero());
+  }
+
+  /**
+   * Account for the latency of a successfully completed op. Zero-length
+   * samples are ignored.
+   * @returns true if the concurrency changed
+   */
+  bool update(const ceph::timespan& latency);
+
+private:
+  uint64_t m_concurrency = 0;
+  uint64_t m_limit = 0;
+  uint64_t m_window_completions = 0;
+  std::optional<ceph::timespan> m_min_latency;
+  ceph::timespan m_avg_latency = ceph::timespan::zero();
+};
+
+} // namespace librbd
+
+#endif // CEPH_LIBRBD_ADAPTIVE_CONCURRENCY_H
@@ -24,12 +24,15 @@ AsyncObjectThrottle<T>::AsyncObjectThrottle(
 }
 
 template <typename T>
-void AsyncObjectThrottle<T>::start_ops(uint64_t max_concurrent) {
+void AsyncObjectThrottle<T>::start_ops(uint64_t max_concurrent,
+                                       uint64_t max_concurrent_limit) {
   ceph_assert(ceph_mutex_is_locked(m_image_ctx.owner_lock));
   bool complete;
   {
     std::lock_guard l{m_lock};
-    for (uint64_t i = 0; i < max_concurrent; ++i) {
+    m_max_ops.reset(max_concurrent, max_concurrent_limit);
+
+    for (uint64_t i = 0; i < m_max_ops.get(); ++i) {
       start_next_op();
       if (m_ret < 0 && m_current_ops == 0) {
 	break;
@@ -45,7 +48,8 @@ void AsyncObjectThrottle<T>::start_ops(uint64_t max_concurrent) {
 }
 
 template <typename T>
-void AsyncObjectThrottle<T>::finish_op(int r) {
+void AsyncObjectThrottle<T>::finish_op(int r,
+                                       const ceph::timespan& latency) {
   bool complete;
   {
     std::shared_lock owner_locker{m_image_ctx.owner_lock};
@@ -55,7 +59,11 @@ void AsyncObjectThrottle<T>::finish_op(int r) {
       m_ret = r;
     }
 
-    start_next_op();
+    if (r >= 0) {
+      m_max_ops.update(latency);
+    }
+    while (m_current_ops < m_max_ops.get() && start_next_op()) {
+    }
     complete = (m_current_ops == 0);
   }
   if (complete) {
@@ -65,16 +73,16 @@ void AsyncObjectThrottle<T>::finish_op(int r) {
 }
 
 template <typename T>
-void AsyncObjectThrottle<T>::start_next_op() {
+bool AsyncObjectThrottle<T>::start_next_op() {
   bool done = false;
   while (!done) {
     if (m_async_request != NULL && m_async_request->is_canceled() &&
         m_ret == 0) {
       // allow in-flight ops to complete, but don't start new ops
       m_ret = -ERESTART;
-      return;
+      return false;
     } else if (m_ret != 0 || m_object_no >= m_end_object_no) {
-      return;
+      return false;
     }
 
     uint64_t ono = m_object_no++;
@@ -84,7 +92,7 @@ void AsyncObjectThrottle<T>::start_next_op() {
     if (r < 0) {
       m_ret = r;
       delete ctx;
-      return;
+      return false;
     } else if (r > 0) {
       // op completed immediately
       delete ctx;
@@ -99,6 +107,7 @@ void AsyncObjectThrottle<T>::start_next_op() {
       }
     }
   }
+  return true;
 }
 
 } // namespace librbd
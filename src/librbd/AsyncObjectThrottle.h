@@ -5,6 +5,8 @@
 
 #include "include/int_types.h"
 #include "include/Context.h"
+#include "common/ceph_time.h"
+#include "librbd/AdaptiveConcurrency.h"
 
 #include <boost/function.hpp>
 
@@ -17,7 +19,7 @@ struct ImageCtx;
 class AsyncObjectThrottleFinisher {
 public:
   virtual ~AsyncObjectThrottleFinisher() {};
-  virtual void finish_op(int r) = 0;
+  virtual void finish_op(int r, const ceph::timespan& latency) = 0;
 };
 
 template <typename ImageCtxT = ImageCtx>
@@ -34,11 +36,12 @@ protected:
   ImageCtxT &m_image_ctx;
 
   void finish(int r) override {
-    m_finisher.finish_op(r);
+    m_finisher.finish_op(r, ceph::mono_clock::now() - m_start_time);
   }
 
 private:
   AsyncObjectThrottleFinisher &m_finisher;
+  ceph::mono_time m_start_time = ceph::mono_clock::now();
 };
 
 template <typename ImageCtxT = ImageCtx>
@@ -54,8 +57,13 @@ public:
 		      ProgressContext *prog_ctx, uint64_t object_no,
 		      uint64_t end_object_no);
 
-  void start_ops(uint64_t max_concurrent);
-  void finish_op(int r) override;
+  /**
+   * Start up to max_concurrent ops. If max_concurrent_limit is non-zero, the
+   * concurrency is adapted between one and that limit based upon the
+   * observed op latencies.
+   */
+  void start_ops(uint64_t max_concurrent, uint64_t max_concurrent_limit = 0);
+  void finish_op(int r, const ceph::timespan& latency) override;
 
 private:
   ceph::mutex m_lock;
@@ -69,7 +77,9 @@ private:
   uint64_t m_current_ops;
   int m_ret;
 
-  void start_next_op();
+  AdaptiveConcurrency m_max_ops;
+
+  bool start_next_op();
 };
 
 } // namespace librbd
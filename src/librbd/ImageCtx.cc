@@ -843,6 +843,7 @@ librados::IoCtx duplicate_io_ctx(librados::IoCtx& io_ctx) {
     ASSIGN_OPTION(cache, bool);
     ASSIGN_OPTION(sparse_read_threshold_bytes, Option::size_t);
     ASSIGN_OPTION(clone_copy_on_read, bool);
+    ASSIGN_OPTION(clone_copy_on_read_prefetch_objects, uint64_t);
     ASSIGN_OPTION(enable_alloc_hint, bool);
     ASSIGN_OPTION(mirroring_replay_delay, uint64_t);
     ASSIGN_OPTION(mtime_update_interval, uint64_t);
@@ -922,6 +923,18 @@ librados::IoCtx duplicate_io_ctx(librados::IoCtx& io_ctx) {
       config.get_val<uint64_t>("rbd_qos_write_bps_limit"),
       config.get_val<uint64_t>("rbd_qos_write_bps_burst"),
       config.get_val<uint64_t>("rbd_qos_write_bps_burst_seconds"));
+    // image level overrides of the shared pool limits are dropped on
+    // refresh so every image of the pool applies the same values
+    io_image_dispatcher->apply_qos_limit(
+      io::IMAGE_DISPATCH_FLAG_QOS_POOL_IOPS_THROTTLE,
+      config.get_val<uint64_t>("rbd_qos_pool_iops_limit"),
+      config.get_val<uint64_t>("rbd_qos_pool_iops_burst"),
+      config.get_val<uint64_t>("rbd_qos_pool_iops_burst_seconds"));
+    io_image_dispatcher->apply_qos_limit(
+      io::IMAGE_DISPATCH_FLAG_QOS_POOL_BPS_THROTTLE,
+      config.get_val<uint64_t>("rbd_qos_pool_bps_limit"),
+      config.get_val<uint64_t>("rbd_qos_pool_bps_burst"),
+      config.get_val<uint64_t>("rbd_qos_pool_bps_burst_seconds"));
     io_image_dispatcher->apply_qos_exclude_ops(
       librbd::io::rbd_io_operations_from_string(
         config.get_val<std::string>("rbd_qos_exclude_ops"), nullptr));
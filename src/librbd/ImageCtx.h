@@ -180,6 +180,7 @@ namespace librbd {
     std::atomic<uint64_t> total_bytes_read = {0};
 
     std::map<uint64_t, io::CopyupRequest<ImageCtx>*> copyup_list;
+    uint64_t copyup_prefetch_in_flight = 0; // protected by copyup_list_lock
 
     xlist<io::AsyncOperation*> async_ops;
     xlist<AsyncRequest<>*> async_requests;
@@ -205,6 +206,9 @@ namespace librbd {
     Completions event_socket_completions;
     EventSocket event_socket;
 
+    /// LIFO of completions awaiting their external callback
+    std::atomic<io::AioCompletion*> external_callback_completions{nullptr};
+
     bool ignore_migrating = false;
     bool disable_zero_copy = false;
     bool enable_sparse_copyup = false;
@@ -216,6 +220,7 @@ namespace librbd {
     uint64_t readahead_max_bytes = 0;
     uint64_t readahead_disable_after_bytes = 0;
     bool clone_copy_on_read;
+    uint64_t clone_copy_on_read_prefetch_objects;
     bool enable_alloc_hint;
     uint32_t alloc_hint_flags = 0U;
     uint32_t read_flags = 0U;  // librados::OPERATION_*
@@ -48,7 +48,13 @@ static std::set<std::string_view> EXCLUDE_IMAGE_OPTIONS {
     "rbd_default_stripe_unit",
     "rbd_journal_order",
     "rbd_journal_pool",
-    "rbd_journal_splay_width"
+    "rbd_journal_splay_width",
+    "rbd_qos_pool_bps_burst",
+    "rbd_qos_pool_bps_burst_seconds",
+    "rbd_qos_pool_bps_limit",
+    "rbd_qos_pool_iops_burst",
+    "rbd_qos_pool_iops_burst_seconds",
+    "rbd_qos_pool_iops_limit"
   };
 
 struct Options : Parent {
@@ -295,6 +295,22 @@ int DiffIterate<I>::execute() {
     uint64_t period_off = off - (off % period);
     uint64_t read_len = std::min(period_off + period - off, left);
 
+    if (fast_diff_enabled && (from_snap_id != 0 || parent_diff.empty())) {
+      // skip over whole periods whose objects are all unchanged holes
+      uint64_t stripe_count = m_image_ctx.layout.stripe_count;
+      uint64_t next_object_no = object_diff_state.find_first_not_of(
+        object_map::DIFF_STATE_HOLE, (off / period) * stripe_count);
+      uint64_t next_off = (next_object_no / stripe_count) * period;
+      if (next_off > off) {
+        uint64_t skip_len = std::min(next_off - off, left);
+        ldout(cct, 20) << "skipping holes: off=" << off << ", len="
+                       << skip_len << dendl;
+        left -= skip_len;
+        off += skip_len;
+        continue;
+      }
+    }
+
     if (fast_diff_enabled) {
       // map to extents
       std::map<object_t,std::vector<ObjectExtent> > object_extents;
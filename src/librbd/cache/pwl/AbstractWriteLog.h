@@ -203,8 +203,10 @@ private:
   std::shared_ptr<pwl::SyncPoint> m_current_sync_point = nullptr;
   bool m_persist_on_flush = false; //If false, persist each write before completion
 
-  int m_flush_ops_in_flight = 0;
-  int m_flush_bytes_in_flight = 0;
+  uint64_t m_flush_ops_in_flight = 0;
+  uint64_t m_flush_bytes_in_flight = 0;
+  uint64_t m_max_flush_ops_in_flight;
+  uint64_t m_max_flush_bytes_in_flight;
   uint64_t m_lowest_flushing_sync_gen = 0;
 
   /* Writes that have left the block guard, but are waiting for resources */
@@ -285,16 +285,42 @@ void WriteLog<I>::load_existing_entries(pwl::DeferredContexts &later) {
   std::map<uint64_t, std::shared_ptr<SyncPointLogEntry>> sync_point_entries;
   std::map<uint64_t, bool> missing_sync_points;
 
+  // With small writes control blocks are only a few data blocks apart, so
+  // read the ring in large chunks rather than issuing a 4k read per control
+  // block. With large writes a chunk would hold little more than a single
+  // control block, so only read the control block itself then.
+  bufferlist bl_read;
+  uint64_t read_pos = 0;
+  uint64_t last_stride = 0;
+
   // Iterate through the log_entries and append all the write_bytes
   // of each entry to fetch the pos of next 4k of log_entries. Iterate
   // through the log entries and append them to the in-memory vector
   for (uint64_t next_log_pos = this->m_first_valid_entry;
        next_log_pos != this->m_first_free_entry; ) {
-    // read the entries from SSD cache and decode
+    if (next_log_pos < read_pos ||
+        next_log_pos + MIN_WRITE_ALLOC_SSD_SIZE > read_pos + bl_read.length()) {
+      uint64_t read_len = MIN_WRITE_ALLOC_SSD_SIZE;
+      if (last_stride > 0 && last_stride < SSD_LOAD_READ_SIZE) {
+        uint64_t read_end = (next_log_pos < this->m_first_free_entry ?
+                             this->m_first_free_entry : this->m_log_pool_size);
+        read_len = std::min<uint64_t>(SSD_LOAD_READ_SIZE,
+                                      read_end - next_log_pos);
+        read_len = std::max<uint64_t>(
+          p2align<uint64_t>(read_len, MIN_WRITE_ALLOC_SSD_SIZE),
+          MIN_WRITE_ALLOC_SSD_SIZE);
+      }
+
+      bl_read.clear();
+      ::IOContext ioctx_entry(cct, nullptr);
+      bdev->read(next_log_pos, read_len, &bl_read, &ioctx_entry, false);
+      read_pos = next_log_pos;
+    }
+
+    // decode the entries of the control block
     bufferlist bl_entries;
-    ::IOContext ioctx_entry(cct, nullptr);
-    bdev->read(next_log_pos, MIN_WRITE_ALLOC_SSD_SIZE, &bl_entries,
-               &ioctx_entry, false);
+    bl_entries.substr_of(bl_read, next_log_pos - read_pos,
+                         MIN_WRITE_ALLOC_SSD_SIZE);
     std::vector<WriteLogCacheEntry> ssd_log_entries;
     auto pl = bl_entries.cbegin();
     decode(ssd_log_entries, pl);
@@ -313,6 +339,7 @@ void WriteLog<I>::load_existing_entries(pwl::DeferredContexts &later) {
     }
     // along with the write_bytes, add control block size too
     next_log_pos += MIN_WRITE_ALLOC_SSD_SIZE;
+    last_stride = next_log_pos - curr_log_pos;
     if (next_log_pos >= this->m_log_pool_size) {
       next_log_pos = next_log_pos % this->m_log_pool_size + DATA_RING_BUFFER_OFFSET;
     }
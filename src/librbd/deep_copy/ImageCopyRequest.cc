@@ -142,12 +142,15 @@ void ImageCopyRequest<I>::send_object_copies() {
   bool complete;
   {
     std::lock_guard locker{m_lock};
-    auto max_ops = m_src_image_ctx->config.template get_val<uint64_t>(
-      "rbd_concurrent_management_ops");
+    m_max_ops.reset(
+      m_src_image_ctx->config.template get_val<uint64_t>(
+        "rbd_concurrent_management_ops"),
+      m_src_image_ctx->config.template get_val<uint64_t>(
+        "rbd_deep_copy_max_concurrent_ops"));
 
     // attempt to schedule at least 'max_ops' initial requests where
     // some objects might be skipped if fast-diff notes no change
-    for (uint64_t i = 0; i < max_ops; i++) {
+    for (uint64_t i = 0; i < m_max_ops.get(); i++) {
       send_next_object_copy();
     }
 
@@ -160,7 +163,7 @@ void ImageCopyRequest<I>::send_object_copies() {
 }
 
 template <typename I>
-void ImageCopyRequest<I>::send_next_object_copy() {
+bool ImageCopyRequest<I>::send_next_object_copy() {
   ceph_assert(ceph_mutex_is_locked(m_lock));
 
   if (m_canceled && m_ret_val == 0) {
@@ -169,15 +172,10 @@ void ImageCopyRequest<I>::send_next_object_copy() {
   }
 
   if (m_ret_val < 0 || m_object_no >= m_end_object_no) {
-    return;
+    return false;
   }
 
   uint64_t ono = m_object_no++;
-  Context *ctx = new LambdaContext(
-    [this, ono](int r) {
-      handle_object_copy(ono, r);
-    });
-
   ldout(m_cct, 20) << "object_num=" << ono << dendl;
   ++m_current_ops;
 
@@ -203,8 +201,14 @@ void ImageCopyRequest<I>::send_next_object_copy() {
 
     if (object_diff_state == object_map::DIFF_STATE_HOLE) {
       ldout(m_cct, 20) << "skipping non-existent object " << ono << dendl;
+
+      // skipped objects should not skew the observed copy latency
+      Context *ctx = new LambdaContext(
+        [this, ono](int r) {
+          handle_object_copy(ono, std::nullopt, r);
+        });
       create_async_context_callback(*m_src_image_ctx, ctx)->complete(0);
-      return;
+      return true;
     }
   }
 
@@ -217,14 +221,20 @@ void ImageCopyRequest<I>::send_next_object_copy() {
     flags |= OBJECT_COPY_REQUEST_FLAG_EXISTS_CLEAN;
   }
 
+  Context *ctx = new LambdaContext(
+    [this, ono, start_time=mono_clock::now()](int r) {
+      handle_object_copy(ono, mono_clock::now() - start_time, r);
+    });
   auto req = ObjectCopyRequest<I>::create(
     m_src_image_ctx, m_dst_image_ctx, m_src_snap_id_start, m_dst_snap_id_start,
     m_snap_map, ono, flags, m_handler, ctx);
   req->send();
+  return true;
 }
 
 template <typename I>
-void ImageCopyRequest<I>::handle_object_copy(uint64_t object_no, int r) {
+void ImageCopyRequest<I>::handle_object_copy(
+    uint64_t object_no, const std::optional<ceph::timespan>& latency, int r) {
   ldout(m_cct, 20) << "object_no=" << object_no << ", r=" << r << dendl;
 
   bool complete;
@@ -233,6 +243,13 @@ void ImageCopyRequest<I>::handle_object_copy(uint64_t object_no, int r) {
     ceph_assert(m_current_ops > 0);
     --m_current_ops;
 
+    if (latency && r >= 0 && m_max_ops.update(*latency)) {
+      ldout(m_cct, 15) << "max_ops=" << m_max_ops.get() << ", "
+                       << "avg_latency=" << m_max_ops.get_avg_latency() << ", "
+                       << "min_latency=" << m_max_ops.get_min_latency()
+                       << dendl;
+    }
+
     if (r < 0 && r != -ENOENT) {
       lderr(m_cct) << "object copy failed: " << cpp_strerror(r) << dendl;
       if (m_ret_val == 0) {
@@ -255,7 +272,8 @@ void ImageCopyRequest<I>::handle_object_copy(uint64_t object_no, int r) {
       }
     }
 
-    send_next_object_copy();
+    while (m_current_ops < m_max_ops.get() && send_next_object_copy()) {
+    }
     complete = (m_current_ops == 0) && !m_updating_progress;
   }
 
@@ -8,11 +8,14 @@
 #include "include/rados/librados.hpp"
 #include "common/bit_vector.hpp"
 #include "common/ceph_mutex.h"
+#include "common/ceph_time.h"
 #include "common/RefCountedObj.h"
+#include "librbd/AdaptiveConcurrency.h"
 #include "librbd/Types.h"
 #include "librbd/deep_copy/Types.h"
 #include <functional>
 #include <map>
+#include <optional>
 #include <queue>
 #include <set>
 #include <vector>
@@ -95,6 +98,9 @@ private:
   uint64_t m_object_no = 0;
   uint64_t m_end_object_no = 0;
   uint64_t m_current_ops = 0;
+
+  AdaptiveConcurrency m_max_ops;
+
   std::priority_queue<
     uint64_t, std::vector<uint64_t>, std::greater<uint64_t>> m_copied_objects;
   bool m_updating_progress = false;
@@ -109,8 +115,9 @@ private:
   void handle_compute_diff(int r);
 
   void send_object_copies();
-  void send_next_object_copy();
-  void handle_object_copy(uint64_t object_no, int r);
+  bool send_next_object_copy();
+  void handle_object_copy(uint64_t object_no,
+                          const std::optional<ceph::timespan>& latency, int r);
 
   void finish(int r);
 };
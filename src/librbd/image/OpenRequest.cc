@@ -262,6 +262,13 @@ void OpenRequest<I>::send_v2_get_initial_metadata() {
   cls_client::get_size_start(&op, CEPH_NOSNAP);
   cls_client::get_object_prefix_start(&op);
   cls_client::get_features_start(&op, true);
+  if (!m_legacy_initial_metadata) {
+    // batch the remaining immutable metadata to avoid extra round-trips
+    cls_client::get_create_timestamp_start(&op);
+    cls_client::get_access_timestamp_start(&op);
+    cls_client::get_modify_timestamp_start(&op);
+    cls_client::get_data_pool_start(&op);
+  }
 
   using klass = OpenRequest<I>;
   librados::AioCompletion *comp = create_rados_callback<
@@ -277,6 +284,13 @@ Context *OpenRequest<I>::handle_v2_get_initial_metadata(int *result) {
   CephContext *cct = m_image_ctx->cct;
   ldout(cct, 10) << __func__ << ": r=" << *result << dendl;
 
+  if (*result == -EOPNOTSUPP && !m_legacy_initial_metadata) {
+    ldout(cct, 10) << "retrying w/o batched metadata" << dendl;
+    m_legacy_initial_metadata = true;
+    send_v2_get_initial_metadata();
+    return nullptr;
+  }
+
   auto it = m_out_bl.cbegin();
   if (*result >= 0) {
     uint64_t size;
@@ -294,6 +308,24 @@ Context *OpenRequest<I>::handle_v2_get_initial_metadata(int *result) {
                                               &incompatible_features);
   }
 
+  if (!m_legacy_initial_metadata) {
+    if (*result >= 0) {
+      *result = cls_client::get_create_timestamp_finish(
+        &it, &m_image_ctx->create_timestamp);
+    }
+    if (*result >= 0) {
+      *result = cls_client::get_access_timestamp_finish(
+        &it, &m_image_ctx->access_timestamp);
+    }
+    if (*result >= 0) {
+      *result = cls_client::get_modify_timestamp_finish(
+        &it, &m_image_ctx->modify_timestamp);
+    }
+    if (*result >= 0) {
+      *result = cls_client::get_data_pool_finish(&it, &m_data_pool_id);
+    }
+  }
+
   if (*result < 0) {
     lderr(cct) << "failed to retrieve initial metadata: "
                << cpp_strerror(*result) << dendl;
@@ -355,6 +387,12 @@ Context *OpenRequest<I>::handle_v2_get_stripe_unit_count(int *result) {
 
 template <typename I>
 void OpenRequest<I>::send_v2_get_create_timestamp() {
+  if (!m_legacy_initial_metadata) {
+    // timestamps and data pool were retrieved w/ the initial metadata
+    init_data_pool();
+    return;
+  }
+
   CephContext *cct = m_image_ctx->cct;
   ldout(cct, 10) << this << " " << __func__ << dendl;
 
@@ -473,13 +511,21 @@ Context *OpenRequest<I>::handle_v2_get_data_pool(int *result) {
     return nullptr;
   }
 
+  m_data_pool_id = data_pool_id;
+  init_data_pool();
+  return nullptr;
+}
+
+template <typename I>
+void OpenRequest<I>::init_data_pool() {
+  int64_t data_pool_id = m_data_pool_id;
   if (data_pool_id != -1) {
-    *result = util::create_ioctx(m_image_ctx->md_ctx, "data pool", data_pool_id,
-                                 {}, &m_image_ctx->data_ctx);
-    if (*result < 0) {
-      if (*result != -ENOENT) {
-        send_close_image(*result);
-        return nullptr;
+    int r = util::create_ioctx(m_image_ctx->md_ctx, "data pool", data_pool_id,
+                               {}, &m_image_ctx->data_ctx);
+    if (r < 0) {
+      if (r != -ENOENT) {
+        send_close_image(r);
+        return;
       }
       m_image_ctx->data_ctx.close();
     } else {
@@ -491,7 +537,6 @@ Context *OpenRequest<I>::handle_v2_get_data_pool(int *result) {
 
   m_image_ctx->init_layout(data_pool_id);
   send_refresh();
-  return nullptr;
 }
 
 template <typename I>
@@ -52,13 +52,16 @@ private:
    *            V2_GET_STRIPE_UNIT_COUNT (skip if   |
    *                |                     disabled) |
    *                v                               |
-   *            V2_GET_CREATE_TIMESTAMP             |
-   *                |                               |
+   *            V2_GET_CREATE_TIMESTAMP (skip if    |
+   *                |                    batched)   |
    *                v                               |
    *            V2_GET_ACCESS_MODIFY_TIMESTAMP      |
+   *                |           (skip if batched)   |
+   *                v                               |
+   *            V2_GET_DATA_POOL (skip if batched)  |
    *                |                               |
    *                v                               |
-   *            V2_GET_DATA_POOL --------------> REFRESH
+   *            <init data pool> -------------> REFRESH
    *                                                |
    *                                                v
    *                                             INIT_PLUGIN_REGISTRY
@@ -88,6 +91,9 @@ private:
   Context *m_on_finish;
 
   bufferlist m_out_bl;
+
+  bool m_legacy_initial_metadata = false;
+  int64_t m_data_pool_id = -1;
   int m_error_result;
 
   void send_v1_detect_header();
@@ -119,6 +125,7 @@ private:
 
   void send_v2_get_data_pool();
   Context *handle_v2_get_data_pool(int *result);
+  void init_data_pool();
 
   void send_refresh();
   Context *handle_refresh(int *result);
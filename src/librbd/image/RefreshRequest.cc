@@ -371,6 +371,11 @@ void RefreshRequest<I>::send_v2_get_mutable_metadata() {
   cls_client::get_flags_start(&op, CEPH_NOSNAP);
   cls_client::get_snapcontext_start(&op);
   rados::cls::lock::get_lock_info_start(&op, RBD_LOCK_NAME);
+  if (!m_legacy_parent) {
+    // batched w/ the mutable metadata to avoid an extra round-trip
+    cls_client::parent_get_start(&op);
+    cls_client::parent_overlap_get_start(&op, CEPH_NOSNAP);
+  }
 
   using klass = RefreshRequest<I>;
   librados::AioCompletion *comp = create_rados_callback<
@@ -388,6 +393,14 @@ Context *RefreshRequest<I>::handle_v2_get_mutable_metadata(int *result) {
   ldout(cct, 10) << this << " " << __func__ << ": "
                  << "r=" << *result << dendl;
 
+  if (*result == -EOPNOTSUPP && !m_legacy_parent) {
+    // NOTE: remove support when Mimic is EOLed
+    ldout(cct, 10) << "retrying using legacy parent method" << dendl;
+    m_legacy_parent = true;
+    send_v2_get_mutable_metadata();
+    return nullptr;
+  }
+
   auto it = m_out_bl.cbegin();
   if (*result >= 0) {
     uint8_t order;
@@ -416,6 +429,10 @@ Context *RefreshRequest<I>::handle_v2_get_mutable_metadata(int *result) {
     }
   }
 
+  if (*result >= 0 && !m_legacy_parent) {
+    *result = decode_parent(&it);
+  }
+
   if (*result < 0) {
     lderr(cct) << "failed to retrieve mutable metadata: "
                << cpp_strerror(*result) << dendl;
@@ -458,25 +475,46 @@ Context *RefreshRequest<I>::handle_v2_get_mutable_metadata(int *result) {
   }
   m_read_only = (m_read_only_flags != 0U);
 
-  m_legacy_parent = false;
-  send_v2_get_parent();
+  if (m_legacy_parent) {
+    send_v2_get_parent();
+    return nullptr;
+  }
+
+  send_v2_get_migration_header_or_metadata();
   return nullptr;
 }
 
+template <typename I>
+int RefreshRequest<I>::decode_parent(bufferlist::const_iterator *it) {
+  int r = cls_client::parent_get_finish(it, &m_parent_md.spec);
+  if (r < 0) {
+    return r;
+  }
+
+  std::optional<uint64_t> parent_overlap;
+  r = cls_client::parent_overlap_get_finish(it, &parent_overlap);
+  if (r < 0) {
+    return r;
+  }
+
+  if (parent_overlap) {
+    m_parent_md.overlap = *parent_overlap;
+    m_head_parent_overlap = true;
+  } else {
+    m_parent_md.overlap = 0;
+    m_head_parent_overlap = false;
+  }
+  return 0;
+}
+
 template <typename I>
 void RefreshRequest<I>::send_v2_get_parent() {
   // NOTE: remove support when Mimic is EOLed
   CephContext *cct = m_image_ctx.cct;
-  ldout(cct, 10) << this << " " << __func__ << ": legacy=" << m_legacy_parent
-                 << dendl;
+  ldout(cct, 10) << this << " " << __func__ << dendl;
 
   librados::ObjectReadOperation op;
-  if (!m_legacy_parent) {
-    cls_client::parent_get_start(&op);
-    cls_client::parent_overlap_get_start(&op, CEPH_NOSNAP);
-  } else {
-    cls_client::get_parent_start(&op, CEPH_NOSNAP);
-  }
+  cls_client::get_parent_start(&op, CEPH_NOSNAP);
 
   auto aio_comp = create_rados_callback<
     RefreshRequest<I>, &RefreshRequest<I>::handle_v2_get_parent>(this);
@@ -493,50 +531,32 @@ Context *RefreshRequest<I>::handle_v2_get_parent(int *result) {
   ldout(cct, 10) << this << " " << __func__ << ": r=" << *result << dendl;
 
   auto it = m_out_bl.cbegin();
-  if (!m_legacy_parent) {
-    if (*result >= 0) {
-      *result = cls_client::parent_get_finish(&it, &m_parent_md.spec);
-    }
-
-    std::optional<uint64_t> parent_overlap;
-    if (*result >= 0) {
-      *result = cls_client::parent_overlap_get_finish(&it, &parent_overlap);
-    }
-
-    if (*result >= 0) {
-      if (parent_overlap) {
-        m_parent_md.overlap = *parent_overlap;
-        m_head_parent_overlap = true;
-      } else {
-        m_parent_md.overlap = 0;
-        m_head_parent_overlap = false;
-      }
-    }
-  } else if (*result >= 0) {
+  if (*result >= 0) {
     *result = cls_client::get_parent_finish(&it, &m_parent_md.spec,
                                             &m_parent_md.overlap);
     m_head_parent_overlap = true;
   }
 
-  if (*result == -EOPNOTSUPP && !m_legacy_parent) {
-    ldout(cct, 10) << "retrying using legacy parent method" << dendl;
-    m_legacy_parent = true;
-    send_v2_get_parent();
-    return nullptr;
-  } else if (*result < 0) {
+  if (*result < 0) {
     lderr(cct) << "failed to retrieve parent: " << cpp_strerror(*result)
                << dendl;
     return m_on_finish;
   }
 
+  send_v2_get_migration_header_or_metadata();
+  return nullptr;
+}
+
+template <typename I>
+void RefreshRequest<I>::send_v2_get_migration_header_or_metadata() {
   if ((m_features & RBD_FEATURE_MIGRATING) != 0) {
+    CephContext *cct = m_image_ctx.cct;
     ldout(cct, 1) << "migrating feature set" << dendl;
     send_get_migration_header();
   } else {
     m_migration_spec = {};
     send_v2_get_metadata();
   }
-  return nullptr;
 }
 
 template <typename I>
@@ -565,6 +585,17 @@ Context *RefreshRequest<I>::handle_v2_get_metadata(int *result) {
     return m_on_finish;
   }
 
+  // the pool QoS throttles are shared by all images of the pool namespace
+  // so their limits can only come from the pool or global config
+  const std::string pool_qos_prefix(ImageCtx::METADATA_CONF_PREFIX +
+                                    "rbd_qos_pool_");
+  for (auto it = m_metadata.lower_bound(pool_qos_prefix);
+       it != m_metadata.end() &&
+         it->first.compare(0, pool_qos_prefix.size(), pool_qos_prefix) == 0; ) {
+    ldout(cct, 5) << "ignoring image level override " << it->first << dendl;
+    it = m_metadata.erase(it);
+  }
+
   send_v2_get_pool_metadata();
   return nullptr;
 }
@@ -52,12 +52,12 @@ private:
    *  * |                                                     |     migrating)
    *  * | (v2)                                                v
    *  * \-----> V2_GET_MUTABLE_METADATA                   V1_GET_SNAPSHOTS
-   *  *    *        |                                         |
-   *  *    *        |     -EOPNOTSUPP                         v
-   *  *    *        |  * * *                              V1_GET_LOCKS
-   *  *    *        |  *   *                                  |
-   *  *    *        v  v   *                                  v
-   *  *    *    V2_GET_PARENT                              <apply>
+   *  *    *        |   ^                                     |
+   *  *    *        |   * -EOPNOTSUPP                         v
+   *  *    *        |   * (retry w/o parent)              V1_GET_LOCKS
+   *  *    *        |   *                                     |
+   *  *    *        v * *                                     v
+   *  *    *    V2_GET_PARENT (skip unless legacy)         <apply>
    *  *    *        |                                         |
    *  *             v                                         |
    *  * * * * * GET_MIGRATION_HEADER (skip if not             |
@@ -197,8 +197,10 @@ private:
   void send_v2_get_mutable_metadata();
   Context *handle_v2_get_mutable_metadata(int *result);
 
+  int decode_parent(bufferlist::const_iterator *it);
   void send_v2_get_parent();
   Context *handle_v2_get_parent(int *result);
+  void send_v2_get_migration_header_or_metadata();
 
   void send_v2_get_metadata();
   Context *handle_v2_get_metadata(int *result);
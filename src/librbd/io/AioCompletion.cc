@@ -35,9 +35,11 @@ int AioCompletion::wait_for_complete() {
   tracepoint(librbd, aio_wait_for_complete_enter, this);
   {
     std::unique_lock<std::mutex> locker(lock);
+    ++waiters;
     while (state != AIO_STATE_COMPLETE) {
       cond.wait(locker);
     }
+    --waiters;
   }
   tracepoint(librbd, aio_wait_for_complete_exit, 0);
   return 0;
@@ -256,13 +258,48 @@ void AioCompletion::complete_external_callback() {
   get();
 
   // ensure librbd external users never experience concurrent callbacks
-  // from multiple librbd-internal threads.
-  boost::asio::dispatch(ictx->asio_engine->get_api_strand(), [this]() {
-      complete_cb(rbd_comp, complete_arg);
-      complete_event_socket();
-      notify_callbacks_complete();
-      put();
-    });
+  // from multiple librbd-internal threads. Only the completion that finds
+  // the list empty schedules the strand handler -- any completions that
+  // race in behind it are delivered by that same handler.
+  auto image_ctx = ictx;
+  auto head = image_ctx->external_callback_completions.load();
+  do {
+    next_external_callback = head;
+  } while (!image_ctx->external_callback_completions.compare_exchange_weak(
+             head, this));
+
+  if (head == nullptr) {
+    // this completion cannot be delivered (and the image cannot be closed)
+    // before the handler below runs
+    boost::asio::dispatch(image_ctx->asio_engine->get_api_strand(),
+                          [image_ctx]() {
+        complete_external_callbacks(image_ctx);
+      });
+  }
+}
+
+void AioCompletion::complete_external_callbacks(ImageCtx* ictx) {
+  // detach the list and restore the completion order
+  AioCompletion* comp = ictx->external_callback_completions.exchange(nullptr);
+  AioCompletion* comps = nullptr;
+  while (comp != nullptr) {
+    auto next = comp->next_external_callback;
+    comp->next_external_callback = comps;
+    comps = comp;
+    comp = next;
+  }
+
+  // note: ictx might be destroyed after the last callback
+  while (comps != nullptr) {
+    comp = comps;
+    comps = comp->next_external_callback;
+    comp->next_external_callback = nullptr;
+
+    comp->complete_cb(comp->rbd_comp, comp->complete_arg);
+    comp->complete_event_socket();
+    comp->notify_callbacks_complete();
+    comp->put();
+  }
 }
 
 void AioCompletion::complete_event_socket() {
@@ -275,7 +312,8 @@ void AioCompletion::complete_event_socket() {
 void AioCompletion::notify_callbacks_complete() {
   state = AIO_STATE_COMPLETE;
 
-  {
+  // the lock is only required to wake up wait_for_complete callers
+  if (waiters > 0) {
     std::unique_lock<std::mutex> locker(lock);
     cond.notify_all();
   }
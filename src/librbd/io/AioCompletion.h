@@ -46,6 +46,7 @@ struct AioCompletion {
 
   mutable std::mutex lock;
   std::condition_variable cond;
+  std::atomic<uint32_t> waiters{0};
 
   callback_t complete_cb = nullptr;
   void *complete_arg = nullptr;
@@ -74,6 +75,9 @@ struct AioCompletion {
 
   Context* image_dispatcher_ctx = nullptr;
 
+  /// intrusive link within ImageCtx::external_callback_completions
+  AioCompletion* next_external_callback = nullptr;
+
   template <typename T, void (T::*MF)(int)>
   static void callback_adapter(completion_t cb, void *arg) {
     AioCompletion *comp = reinterpret_cast<AioCompletion *>(cb);
@@ -180,6 +184,7 @@ struct AioCompletion {
 private:
   void queue_complete();
   void complete_external_callback();
+  static void complete_external_callbacks(ImageCtx* ictx);
   void complete_event_socket();
   void notify_callbacks_complete();
 };
@@ -346,6 +346,8 @@ void ObjectReadRequest<I>::copyup() {
     image_ctx->copyup_list_lock.unlock();
     image_ctx->image_lock.unlock_shared();
     new_req->send();
+
+    prefetch_copyup();
   } else {
     image_ctx->copyup_list_lock.unlock();
     image_ctx->image_lock.unlock_shared();
@@ -355,6 +357,67 @@ void ObjectReadRequest<I>::copyup() {
   this->finish(0);
 }
 
+template <typename I>
+void ObjectReadRequest<I>::prefetch_copyup() {
+  I *image_ctx = this->m_ictx;
+  ceph_assert(ceph_mutex_is_locked(image_ctx->owner_lock));
+
+  uint64_t prefetch_objects = image_ctx->clone_copy_on_read_prefetch_objects;
+  if (prefetch_objects == 0) {
+    return;
+  }
+
+  // sequential readers of a clone are likely to touch the following
+  // objects next -- hydrate them in the background so that the reads
+  // do not need to be redirected to the parent image. Without an object
+  // map there is no cheap way to skip objects that already exist.
+  // Concurrent readers share a budget of prefetch_objects in-flight
+  // prefetches per image so that they cannot pile up copyups.
+  std::vector<uint64_t> object_nos;
+  {
+    std::shared_lock image_locker{image_ctx->image_lock};
+    if (image_ctx->object_map == nullptr) {
+      return;
+    }
+
+    uint64_t end_object_no = std::min<uint64_t>(
+      this->m_object_no + 1 + prefetch_objects, image_ctx->object_map->size());
+    std::lock_guard copyup_list_locker{image_ctx->copyup_list_lock};
+    for (uint64_t object_no = this->m_object_no + 1;
+         object_no < end_object_no &&
+           image_ctx->copyup_prefetch_in_flight < prefetch_objects;
+         ++object_no) {
+      if (image_ctx->object_map->object_may_exist(object_no) ||
+          image_ctx->copyup_list.count(object_no) != 0) {
+        continue;
+      }
+      object_nos.push_back(object_no);
+      ++image_ctx->copyup_prefetch_in_flight;
+    }
+  }
+
+  for (size_t i = 0; i < object_nos.size(); ++i) {
+    auto object_no = object_nos[i];
+    ldout(image_ctx->cct, 20) << "prefetching object " << object_no << dendl;
+    // best effort: copyup failures are already logged by the write path
+    auto ctx = new LambdaContext([image_ctx](int r) {
+        std::lock_guard copyup_list_locker{image_ctx->copyup_list_lock};
+        ceph_assert(image_ctx->copyup_prefetch_in_flight > 0);
+        --image_ctx->copyup_prefetch_in_flight;
+      });
+    if (!io::util::trigger_copyup(image_ctx, object_no, this->m_io_context,
+                                  ctx)) {
+      // beyond the parent overlap: release the budget of the rest
+      delete ctx;
+      std::lock_guard copyup_list_locker{image_ctx->copyup_list_lock};
+      ceph_assert(image_ctx->copyup_prefetch_in_flight >=
+                    object_nos.size() - i);
+      image_ctx->copyup_prefetch_in_flight -= object_nos.size() - i;
+      break;
+    }
+  }
+}
+
 /** write **/
 
 template <typename I>
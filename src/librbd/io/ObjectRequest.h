@@ -148,6 +148,7 @@ private:
   void handle_read_parent(int r);
 
   void copyup();
+  void prefetch_copyup();
 };
 
 template <typename ImageCtxT = ImageCtx>
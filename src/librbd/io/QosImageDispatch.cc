@@ -6,6 +6,9 @@
 #include "librbd/AsioEngine.h"
 #include "librbd/ImageCtx.h"
 #include "librbd/io/FlushTracker.h"
+#include <map>
+#include <string>
+#include <tuple>
 #include <utility>
 
 #define dout_subsys ceph_subsys_rbd
@@ -45,6 +48,47 @@ static const std::pair<uint64_t, const char*> throttle_flags[] = {
   {IMAGE_DISPATCH_FLAG_QOS_WRITE_BPS_THROTTLE,  "rbd_qos_write_bps_throttle"  }
 };
 
+static const std::pair<uint64_t, const char*> pool_throttle_flags[] = {
+  {IMAGE_DISPATCH_FLAG_QOS_POOL_IOPS_THROTTLE,  "rbd_qos_pool_iops_throttle"  },
+  {IMAGE_DISPATCH_FLAG_QOS_POOL_BPS_THROTTLE,   "rbd_qos_pool_bps_throttle"   }
+};
+
+struct PoolThrottles {
+  typedef std::tuple<int64_t, std::string, uint64_t> Key;
+
+  CephContext* cct;
+  ceph::mutex lock = ceph::make_mutex(
+    "librbd::io::QosImageDispatch::PoolThrottles::lock");
+  std::map<Key, std::weak_ptr<TokenBucketThrottle>> throttles;
+
+  explicit PoolThrottles(CephContext* cct) : cct(cct) {
+  }
+
+  std::shared_ptr<TokenBucketThrottle> get(int64_t pool_id,
+                                           const std::string& pool_namespace,
+                                           uint64_t flag, const char* name,
+                                           SafeTimer* timer,
+                                           ceph::mutex* timer_lock) {
+    std::lock_guard locker{lock};
+    for (auto it = throttles.begin(); it != throttles.end(); ) {
+      if (it->second.expired()) {
+        it = throttles.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    auto& weak_throttle = throttles[{pool_id, pool_namespace, flag}];
+    auto throttle = weak_throttle.lock();
+    if (!throttle) {
+      throttle = std::make_shared<TokenBucketThrottle>(
+        cct, name, 0, 0, timer, timer_lock);
+      weak_throttle = throttle;
+    }
+    return throttle;
+  }
+};
+
 } // anonymous namespace
 
 template <typename I>
@@ -59,14 +103,18 @@ QosImageDispatch<I>::QosImageDispatch(I* image_ctx)
   for (auto [flag, name] : throttle_flags) {
     m_throttles.emplace_back(
       flag,
-      new TokenBucketThrottle(cct, name, 0, 0, timer, timer_lock));
+      std::make_shared<TokenBucketThrottle>(cct, name, 0, 0, timer,
+                                            timer_lock));
   }
-}
 
-template <typename I>
-QosImageDispatch<I>::~QosImageDispatch() {
-  for (auto t : m_throttles) {
-    delete t.second;
+  auto pool_throttles = &cct->template lookup_or_create_singleton_object<
+    PoolThrottles>("librbd::io::QosImageDispatch::pool_throttles", false, cct);
+  for (auto [flag, name] : pool_throttle_flags) {
+    m_throttles.emplace_back(
+      flag,
+      pool_throttles->get(m_image_ctx->md_ctx.get_id(),
+                          m_image_ctx->md_ctx.get_namespace(), flag, name,
+                          timer, timer_lock));
   }
 }
 
@@ -78,7 +126,7 @@ void QosImageDispatch<I>::shut_down(Context* on_finish) {
 
 template <typename I>
 void QosImageDispatch<I>::apply_qos_schedule_tick_min(uint64_t tick) {
-  for (auto pair : m_throttles) {
+  for (auto& pair : m_throttles) {
     pair.second->set_schedule_tick_min(tick);
   }
 }
@@ -88,9 +136,9 @@ void QosImageDispatch<I>::apply_qos_limit(uint64_t flag, uint64_t limit,
                                           uint64_t burst, uint64_t burst_seconds) {
   auto cct = m_image_ctx->cct;
   TokenBucketThrottle *throttle = nullptr;
-  for (auto pair : m_throttles) {
+  for (auto& pair : m_throttles) {
     if (flag == pair.first) {
-      throttle = pair.second;
+      throttle = pair.second.get();
       break;
     }
   }
@@ -290,7 +338,7 @@ bool QosImageDispatch<I>::needs_throttle(
   *dispatch_result = DISPATCH_RESULT_CONTINUE;
 
   auto qos_enabled_flag = m_qos_enabled_flag;
-  for (auto [flag, throttle] : m_throttles) {
+  for (auto& [flag, throttle] : m_throttles) {
     if ((qos_enabled_flag & flag) == 0) {
       all_qos_flags_set = set_throttle_flag(image_dispatch_flags, flag);
       continue;
@@ -40,7 +40,6 @@ public:
   };
 
   QosImageDispatch(ImageCtxT* image_ctx);
-  ~QosImageDispatch() override;
 
   ImageDispatchLayer get_dispatch_layer() const override {
     return IMAGE_DISPATCH_LAYER_QOS;
@@ -109,7 +108,10 @@ public:
 private:
   ImageCtxT* m_image_ctx;
 
-  std::list<std::pair<uint64_t, TokenBucketThrottle*> > m_throttles;
+  // pool throttles are shared with all other open images within the
+  // same pool namespace
+  std::list<std::pair<uint64_t, std::shared_ptr<TokenBucketThrottle>>>
+    m_throttles;
   uint64_t m_qos_enabled_flag = 0;
   uint64_t m_qos_exclude_ops = 0;
 
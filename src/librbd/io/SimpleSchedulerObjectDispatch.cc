@@ -64,12 +64,14 @@ template <typename I>
 bool SimpleSchedulerObjectDispatch<I>::ObjectRequests::try_delay_request(
     uint64_t object_off, ceph::bufferlist&& data, IOContext io_context,
     int op_flags, int object_dispatch_flags, Context* on_dispatched) {
+  bool overlaps = false;
   if (!m_delayed_requests.empty()) {
     if (!m_io_context || *m_io_context != *io_context ||
         op_flags != m_op_flags || data.length() == 0 ||
-        intersects(object_off, data.length())) {
+        m_delayed_requests.begin()->second.data.length() == 0) {
       return false;
     }
+    overlaps = intersects(object_off, data.length());
   } else {
     m_io_context = io_context;
     m_op_flags = op_flags;
@@ -80,11 +82,18 @@ bool SimpleSchedulerObjectDispatch<I>::ObjectRequests::try_delay_request(
     // and we don't want it to be merged with others
     ceph_assert(m_delayed_requests.empty());
     m_delayed_request_extents.insert(0, UINT64_MAX);
+  } else if (overlaps) {
+    m_delayed_request_extents.union_insert(object_off, data.length());
   } else {
     m_delayed_request_extents.insert(object_off, data.length());
   }
   m_object_dispatch_flags |= object_dispatch_flags;
 
+  if (overlaps) {
+    merge_overlapping_request(object_off, std::move(data), on_dispatched);
+    return true;
+  }
+
   if (!m_delayed_requests.empty()) {
     // try to merge front to an existing request
     auto iter = m_delayed_requests.find(object_off + data.length());
@@ -129,6 +138,48 @@ bool SimpleSchedulerObjectDispatch<I>::ObjectRequests::try_delay_request(
   return true;
 }
 
+template <typename I>
+void SimpleSchedulerObjectDispatch<I>::ObjectRequests::merge_overlapping_request(
+    uint64_t object_off, ceph::bufferlist&& data, Context* on_dispatched) {
+  // the new write arrived after all delayed writes, so its data replaces
+  // the overlapped portion of the delayed writes
+  uint64_t object_end = object_off + data.length();
+
+  auto iter = m_delayed_requests.lower_bound(object_off);
+  if (iter != m_delayed_requests.begin()) {
+    auto prev = iter;
+    --prev;
+    if (prev->first + prev->second.data.length() >= object_off) {
+      iter = prev;
+    }
+  }
+
+  uint64_t merged_off = object_off;
+  MergedRequests merged_requests;
+  ceph::bufferlist suffix;
+  while (iter != m_delayed_requests.end() && iter->first <= object_end) {
+    auto& delayed_data = iter->second.data;
+    uint64_t delayed_end = iter->first + delayed_data.length();
+    if (iter->first < object_off) {
+      merged_off = iter->first;
+      merged_requests.data.substr_of(delayed_data, 0,
+                                     object_off - iter->first);
+    }
+    if (delayed_end > object_end) {
+      suffix.substr_of(delayed_data, object_end - iter->first,
+                       delayed_end - object_end);
+    }
+    merged_requests.requests.splice(merged_requests.requests.end(),
+                                    iter->second.requests);
+    iter = m_delayed_requests.erase(iter);
+  }
+
+  merged_requests.data.append(std::move(data));
+  merged_requests.data.append(std::move(suffix));
+  merged_requests.requests.push_back(on_dispatched);
+  m_delayed_requests[merged_off] = std::move(merged_requests);
+}
+
 template <typename I>
 void SimpleSchedulerObjectDispatch<I>::ObjectRequests::try_merge_delayed_requests(
     typename std::map<uint64_t, MergedRequests>::iterator &iter1,
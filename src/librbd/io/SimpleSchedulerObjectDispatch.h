@@ -181,6 +181,9 @@ private:
     std::map<uint64_t, MergedRequests> m_delayed_requests;
     interval_set<uint64_t> m_delayed_request_extents;
 
+    void merge_overlapping_request(uint64_t object_off,
+                                   ceph::bufferlist&& data,
+                                   Context* on_dispatched);
     void try_merge_delayed_requests(
         typename std::map<uint64_t, MergedRequests>::iterator &iter,
         typename std::map<uint64_t, MergedRequests>::iterator &iter2);
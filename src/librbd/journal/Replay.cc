@@ -28,6 +28,40 @@ static const uint64_t IN_FLIGHT_IO_HIGH_WATER_MARK(64);
 
 static NoOpProgressContext no_op_progress_callback;
 
+struct IOExtentVisitor : public boost::static_visitor<bool> {
+  uint64_t *offset;
+  uint64_t *length;
+
+  IOExtentVisitor(uint64_t *offset, uint64_t *length)
+    : offset(offset), length(length) {
+  }
+
+  template <typename Event>
+  bool set_extent(const Event &event) const {
+    *offset = event.offset;
+    *length = event.length;
+    return true;
+  }
+
+  bool operator()(const AioDiscardEvent &event) const {
+    return set_extent(event);
+  }
+  bool operator()(const AioWriteEvent &event) const {
+    return set_extent(event);
+  }
+  bool operator()(const AioWriteSameEvent &event) const {
+    return set_extent(event);
+  }
+  bool operator()(const AioCompareAndWriteEvent &event) const {
+    return set_extent(event);
+  }
+
+  template <typename Event>
+  bool operator()(const Event &event) const {
+    return false;
+  }
+};
+
 template <typename I, typename E>
 struct ExecuteOp : public Context {
   I &image_ctx;
@@ -175,7 +209,9 @@ struct C_RefreshIfRequired : public Context {
 
 template <typename I>
 Replay<I>::Replay(I &image_ctx)
-  : m_image_ctx(image_ctx) {
+  : m_image_ctx(image_ctx),
+    m_max_concurrent_ios(m_image_ctx.config.template get_val<uint64_t>(
+      "rbd_journal_replay_max_concurrent_ios")) {
 }
 
 template <typename I>
@@ -187,6 +223,8 @@ Replay<I>::~Replay() {
   ceph_assert(m_aio_modify_safe_contexts.empty());
   ceph_assert(m_op_events.empty());
   ceph_assert(m_in_flight_op_events == 0);
+  ceph_assert(m_in_flight_concurrent_ios == 0);
+  ceph_assert(!m_blocked_event);
 }
 
 template <typename I>
@@ -218,10 +256,107 @@ void Replay<I>::process(const EventEntry &event_entry,
     return;
   }
 
+  if (m_max_concurrent_ios > 0) {
+    process_concurrent(event_entry, on_ready, on_safe);
+    return;
+  }
+
   boost::apply_visitor(EventVisitor(this, on_ready, on_safe),
                        event_entry.event);
 }
 
+template <typename I>
+void Replay<I>::process_concurrent(const EventEntry &event_entry,
+                                   Context *on_ready, Context *on_safe) {
+  ceph_assert(ceph_mutex_is_locked(m_image_ctx.owner_lock));
+  CephContext *cct = m_image_ctx.cct;
+
+  uint64_t offset = 0;
+  uint64_t length = 0;
+  bool io_event = boost::apply_visitor(IOExtentVisitor(&offset, &length),
+                                       event_entry.event);
+  {
+    std::lock_guard locker{m_lock};
+    if (!m_shut_down && !can_start_concurrent_event(io_event, offset, length)) {
+      // the next event will be processed once this event is unblocked
+      ldout(cct, 20) << ": blocking event on in-flight IO: "
+                     << "in_flight_ios=" << m_in_flight_concurrent_ios
+                     << dendl;
+      ceph_assert(!m_blocked_event);
+      m_blocked_event = BlockedEvent{event_entry, on_ready, on_safe};
+      return;
+    }
+
+    if (!io_event || m_shut_down) {
+      io_event = false;
+    } else {
+      ++m_in_flight_concurrent_ios;
+      if (length > 0) {
+        m_in_flight_io_extents.insert(offset, length);
+      }
+    }
+  }
+
+  if (!io_event) {
+    boost::apply_visitor(EventVisitor(this, on_ready, on_safe),
+                         event_entry.event);
+    return;
+  }
+
+  // the IO event no longer needs to be acked before the next event is
+  // processed -- the IO extent is tracked until the ack to ensure that
+  // overlapping IO is applied in order
+  auto on_io_ready = util::create_async_context_callback(
+    m_image_ctx, new LambdaContext([this, offset, length](int r) {
+      handle_concurrent_io_ready(offset, length);
+    }));
+  boost::apply_visitor(EventVisitor(this, on_io_ready, on_safe),
+                       event_entry.event);
+  on_ready->complete(0);
+}
+
+template <typename I>
+bool Replay<I>::can_start_concurrent_event(bool io_event, uint64_t offset,
+                                           uint64_t length) const {
+  ceph_assert(ceph_mutex_is_locked(m_lock));
+
+  if (m_on_aio_ready != nullptr) {
+    // paused at the AIO high-water mark
+    return false;
+  } else if (!io_event) {
+    // all other events act as a barrier for in-flight IO
+    return (m_in_flight_concurrent_ios == 0);
+  } else if (m_in_flight_concurrent_ios >= m_max_concurrent_ios) {
+    return false;
+  }
+  return (length == 0 || !m_in_flight_io_extents.intersects(offset, length));
+}
+
+template <typename I>
+void Replay<I>::handle_concurrent_io_ready(uint64_t offset, uint64_t length) {
+  CephContext *cct = m_image_ctx.cct;
+  ldout(cct, 20) << ": offset=" << offset << ", length=" << length << dendl;
+
+  std::optional<BlockedEvent> blocked_event;
+  {
+    std::lock_guard locker{m_lock};
+    ceph_assert(m_in_flight_concurrent_ios > 0);
+    --m_in_flight_concurrent_ios;
+    if (length > 0) {
+      m_in_flight_io_extents.erase(offset, length);
+    }
+    std::swap(blocked_event, m_blocked_event);
+  }
+
+  if (blocked_event) {
+    // re-process the blocked event (it might still be blocked by other
+    // in-flight IO)
+    ldout(cct, 20) << ": retrying blocked event" << dendl;
+    process(blocked_event->event_entry, blocked_event->on_ready,
+            blocked_event->on_safe);
+  }
+}
+
 template <typename I>
 void Replay<I>::shut_down(bool cancel_ops, Context *on_finish) {
   CephContext *cct = m_image_ctx.cct;
@@ -265,6 +400,13 @@ void Replay<I>::shut_down(bool cancel_ops, Context *on_finish) {
     ceph_assert(!m_shut_down);
     m_shut_down = true;
 
+    if (m_blocked_event) {
+      ldout(cct, 5) << ": ignoring blocked event after shut down" << dendl;
+      m_blocked_event->on_ready->complete(0);
+      m_image_ctx.op_work_queue->queue(m_blocked_event->on_safe, -ESHUTDOWN);
+      m_blocked_event.reset();
+    }
+
     ceph_assert(m_flush_ctx == nullptr);
     if (m_in_flight_op_events > 0 || flush_comp != nullptr) {
       std::swap(m_flush_ctx, on_finish);
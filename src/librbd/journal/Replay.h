@@ -8,10 +8,12 @@
 #include "include/buffer_fwd.h"
 #include "include/Context.h"
 #include "common/ceph_mutex.h"
+#include "include/interval_set.h"
 #include "librbd/io/Types.h"
 #include "librbd/journal/Types.h"
 #include <boost/variant.hpp>
 #include <list>
+#include <optional>
 #include <unordered_set>
 #include <unordered_map>
 
@@ -57,6 +59,12 @@ private:
     ReturnValues ignore_error_codes;
   };
 
+  struct BlockedEvent {
+    EventEntry event_entry;
+    Context *on_ready;
+    Context *on_safe;
+  };
+
   typedef std::list<uint64_t> OpTids;
   typedef std::list<Context *> Contexts;
   typedef std::unordered_set<Context *> ContextSet;
@@ -133,6 +141,18 @@ private:
   Context *m_flush_ctx = nullptr;
   Context *m_on_aio_ready = nullptr;
 
+  // concurrent replay of non-overlapping IO events (disabled if zero)
+  uint64_t m_max_concurrent_ios = 0;
+  uint64_t m_in_flight_concurrent_ios = 0;
+  interval_set<uint64_t> m_in_flight_io_extents;
+  std::optional<BlockedEvent> m_blocked_event;
+
+  void process_concurrent(const EventEntry &event_entry, Context *on_ready,
+                          Context *on_safe);
+  bool can_start_concurrent_event(bool io_event, uint64_t offset,
+                                  uint64_t length) const;
+  void handle_concurrent_io_ready(uint64_t offset, uint64_t length);
+
   void handle_event(const AioDiscardEvent &event, Context *on_ready,
                     Context *on_safe);
   void handle_event(const AioWriteEvent &event, Context *on_ready,
@@ -187,53 +187,48 @@ void DiffRequest<I>::handle_load_object_map(int r) {
     m_object_map.resize(m_object_diff_state->size());
   }
 
+  // the object map and diff state are merged a packed word at a time
+  const uint64_t lo = BitVector<2>::word_pattern(1);
   uint64_t overlap = std::min(m_object_map.size(), prev_object_diff_state_size);
-  auto it = m_object_map.begin();
-  auto overlap_end_it = it + overlap;
-  auto diff_it = m_object_diff_state->begin();
-  uint64_t i = 0;
-  for (; it != overlap_end_it; ++it, ++diff_it, ++i) {
-    uint8_t object_map_state = *it;
-    uint8_t prev_object_diff_state = *diff_it;
-    if (object_map_state == OBJECT_EXISTS ||
-        object_map_state == OBJECT_PENDING ||
-        (object_map_state == OBJECT_EXISTS_CLEAN &&
-         prev_object_diff_state != DIFF_STATE_DATA &&
-         prev_object_diff_state != DIFF_STATE_DATA_UPDATED)) {
-      *diff_it = DIFF_STATE_DATA_UPDATED;
-    } else if (object_map_state == OBJECT_NONEXISTENT &&
-               prev_object_diff_state != DIFF_STATE_HOLE &&
-               prev_object_diff_state != DIFF_STATE_HOLE_UPDATED) {
-      *diff_it = DIFF_STATE_HOLE_UPDATED;
-    }
-
-    ldout(cct, 20) << "object state: " << i << " "
-                   << static_cast<uint32_t>(prev_object_diff_state)
-                   << "->" << static_cast<uint32_t>(*diff_it) << " ("
-                   << static_cast<uint32_t>(object_map_state) << ")"
-                   << dendl;
-  }
+  m_object_diff_state->transform(
+    m_object_map, 0, overlap, [lo](uint64_t diff_state, uint64_t object_map) {
+      uint64_t o0 = object_map & lo;
+      uint64_t o1 = (object_map >> 1) & lo;
+      uint64_t p0 = diff_state & lo;
+      uint64_t p1 = (diff_state >> 1) & lo;
+
+      // OBJECT_EXISTS, OBJECT_PENDING or OBJECT_EXISTS_CLEAN w/o prior data
+      uint64_t data_updated = (o0 ^ o1) | (o0 & o1 & ~p0);
+      // OBJECT_NONEXISTENT w/ prior data
+      uint64_t hole_updated = ~(o0 | o1) & p0 & lo;
+      uint64_t n1 = data_updated | hole_updated | p1;
+      uint64_t n0 = data_updated | (p0 & ~hole_updated);
+      return (n1 << 1) | n0;
+    });
   ldout(cct, 20) << "computed overlap diffs" << dendl;
 
   bool diff_from_start = (m_snap_id_start == 0);
-  auto end_it = m_object_map.end();
   if (m_object_map.size() > prev_object_diff_state_size) {
-    for (; it != end_it; ++it,++diff_it, ++i) {
-      uint8_t object_map_state = *it;
-      if (object_map_state == OBJECT_NONEXISTENT) {
-        *diff_it = DIFF_STATE_HOLE;
-      } else if (diff_from_start ||
-                 (m_object_diff_state_valid &&
-                  object_map_state != OBJECT_EXISTS_CLEAN)) {
-        *diff_it = DIFF_STATE_DATA_UPDATED;
-      } else {
-        *diff_it = DIFF_STATE_DATA;
-      }
-
-      ldout(cct, 20) << "object state: " << i << " "
-                     << "->" << static_cast<uint32_t>(*diff_it) << " ("
-                     << static_cast<uint32_t>(*it) << ")" << dendl;
-    }
+    bool object_diff_state_valid = m_object_diff_state_valid;
+    m_object_diff_state->transform(
+      m_object_map, prev_object_diff_state_size,
+      m_object_map.size() - prev_object_diff_state_size,
+      [lo, diff_from_start, object_diff_state_valid](uint64_t,
+                                                     uint64_t object_map) {
+        uint64_t o0 = object_map & lo;
+        uint64_t o1 = (object_map >> 1) & lo;
+
+        // OBJECT_NONEXISTENT -> DIFF_STATE_HOLE, otherwise DIFF_STATE_DATA
+        // or DIFF_STATE_DATA_UPDATED
+        uint64_t exists = o0 | o1;
+        uint64_t updated = 0;
+        if (diff_from_start) {
+          updated = exists;
+        } else if (object_diff_state_valid) {
+          updated = exists & ~(o0 & o1);
+        }
+        return (updated << 1) | exists;
+      });
   }
   ldout(cct, 20) << "computed resize diffs" << dendl;
 
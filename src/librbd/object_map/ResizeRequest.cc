@@ -21,11 +21,8 @@ void ResizeRequest::resize(ceph::BitVector<2> *object_map, uint64_t num_objs,
   size_t orig_object_map_size = object_map->size();
   object_map->resize(num_objs);
   if (num_objs > orig_object_map_size) {
-    auto it = object_map->begin() + orig_object_map_size;
-    auto end_it = object_map->begin() + num_objs;
-    for (;it != end_it; ++it) {
-      *it = default_state;
-    }
+    object_map->set_range(orig_object_map_size,
+                          num_objs - orig_object_map_size, default_state);
   }
 }
 
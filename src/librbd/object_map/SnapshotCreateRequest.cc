@@ -134,13 +134,12 @@ bool SnapshotCreateRequest::send_add_snapshot() {
 void SnapshotCreateRequest::update_object_map() {
   std::unique_lock object_map_locker{*m_object_map_lock};
 
-  auto it = m_object_map.begin();
-  auto end_it = m_object_map.end();
-  for (; it != end_it; ++it) {
-    if (*it == OBJECT_EXISTS) {
-      *it = OBJECT_EXISTS_CLEAN;
-    }
-  }
+  // OBJECT_EXISTS -> OBJECT_EXISTS_CLEAN
+  const uint64_t lo = ceph::BitVector<2>::word_pattern(1);
+  m_object_map.transform(0, m_object_map.size(), [lo](uint64_t word) {
+      uint64_t exists = word & ~(word >> 1) & lo;
+      return word | (exists << 1);
+    });
 }
 
 } // namespace object_map
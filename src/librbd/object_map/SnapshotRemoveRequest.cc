@@ -205,21 +205,21 @@ void SnapshotRemoveRequest::update_object_map() {
     CephContext *cct = m_image_ctx.cct;
     ldout(cct, 5) << dendl;
 
-    auto it = m_object_map.begin();
-    auto end_it = m_object_map.end();
-    auto snap_it = m_snap_object_map.begin();
-    uint64_t i = 0;
-    for (; it != end_it; ++it) {
-      if (*it == OBJECT_EXISTS_CLEAN &&
-          (i >= m_snap_object_map.size() ||
-           *snap_it == OBJECT_EXISTS)) {
-        *it = OBJECT_EXISTS;
-      }
-      if (i < m_snap_object_map.size()) {
-        ++snap_it;
-      }
-      ++i;
-    }
+    // OBJECT_EXISTS_CLEAN -> OBJECT_EXISTS if the object was dirty in the
+    // removed snapshot or did not exist within it
+    const uint64_t lo = ceph::BitVector<2>::word_pattern(1);
+    uint64_t overlap = std::min(m_object_map.size(), m_snap_object_map.size());
+    m_object_map.transform(
+      m_snap_object_map, 0, overlap, [lo](uint64_t word, uint64_t snap_word) {
+        uint64_t clean = word & (word >> 1) & lo;
+        uint64_t snap_exists = snap_word & ~(snap_word >> 1) & lo;
+        return word & ~((clean & snap_exists) << 1);
+      });
+    m_object_map.transform(
+      overlap, m_object_map.size() - overlap, [lo](uint64_t word) {
+        uint64_t clean = word & (word >> 1) & lo;
+        return word & ~(clean << 1);
+      });
   }
 }
 
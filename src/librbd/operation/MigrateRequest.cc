@@ -7,6 +7,7 @@
 #include "librbd/AsyncObjectThrottle.h"
 #include "librbd/ExclusiveLock.h"
 #include "librbd/ImageCtx.h"
+#include "librbd/ObjectMap.h"
 #include "librbd/Utils.h"
 #include "librbd/deep_copy/ObjectCopyRequest.h"
 #include "librbd/io/AsyncOperation.h"
@@ -49,6 +50,16 @@ public:
       return -ERESTART;
     }
 
+    if (is_within_overlap_bounds()) {
+      std::shared_lock image_locker{image_ctx.image_lock};
+      if (image_ctx.object_map != nullptr &&
+          !image_ctx.object_map->object_may_not_exist(m_object_no)) {
+        // already copied up -- e.g. by a write while migrating
+        ldout(cct, 20) << "skipping existing object " << m_object_no << dendl;
+        return 1;
+      }
+    }
+
     start_async_op();
     return 0;
   }
@@ -202,7 +213,9 @@ void MigrateRequest<I>::migrate_objects() {
   AsyncObjectThrottle<I> *throttle = new AsyncObjectThrottle<I>(
     this, image_ctx, context_factory, ctx, &m_prog_ctx, 0, overlap_objects);
   throttle->start_ops(
-    image_ctx.config.template get_val<uint64_t>("rbd_concurrent_management_ops"));
+    image_ctx.config.template get_val<uint64_t>("rbd_concurrent_management_ops"),
+    image_ctx.config.template get_val<uint64_t>(
+      "rbd_deep_copy_max_concurrent_ops"));
 }
 
 template <typename I>
@@ -1654,13 +1654,14 @@ class C_IO_Dir_OMAP_FetchedMore : public CDirIOContext {
   MDSContext *fin;
 public:
   const version_t omap_version;
+  const bool streaming;
   bufferlist hdrbl;
   bool more = false;
   map<string, bufferlist> omap;      ///< carry-over from before
   map<string, bufferlist> omap_more; ///< new batch
   int ret;
-  C_IO_Dir_OMAP_FetchedMore(CDir *d, version_t v, MDSContext *f) :
-    CDirIOContext(d), fin(f), omap_version(v), ret(0) { }
+  C_IO_Dir_OMAP_FetchedMore(CDir *d, version_t v, bool s, MDSContext *f) :
+    CDirIOContext(d), fin(f), omap_version(v), streaming(s), ret(0) { }
   void finish(int r) {
     if (omap_version < dir->get_committed_version()) {
       omap.clear();
@@ -1675,7 +1676,14 @@ public:
       omap.insert(omap_more.begin(), omap_more.end());
     }
     if (more) {
-      dir->_omap_fetch_more(omap_version, hdrbl, omap, fin);
+      std::string last_key = omap.rbegin()->first;
+      if (streaming) {
+	// instantiate this batch now instead of carrying it along
+	dir->_omap_fetched(hdrbl, omap, true, {}, r, true);
+	omap.clear();
+      }
+      dir->_omap_fetch_more(omap_version, hdrbl, omap, last_key, streaming,
+			    fin);
     } else {
       dir->_omap_fetched(hdrbl, omap, true, {}, r);
       if (fin)
@@ -1714,7 +1722,14 @@ public:
       if (omap_version < dir->get_committed_version()) {
 	dir->_omap_fetch(nullptr, fin);
       } else {
-	dir->_omap_fetch_more(omap_version, hdrbl, omap, fin);
+	std::string last_key = omap.rbegin()->first;
+	bool streaming = (r >= 0 && dir->_omap_can_stream(hdrbl));
+	if (streaming) {
+	  dir->_omap_fetched(hdrbl, omap, true, {}, r, true);
+	  omap.clear();
+	}
+	dir->_omap_fetch_more(omap_version, hdrbl, omap, last_key, streaming,
+			      fin);
       }
       return;
     }
@@ -1757,16 +1772,18 @@ void CDir::_omap_fetch(std::set<string> *keys, MDSContext *c)
 }
 
 void CDir::_omap_fetch_more(version_t omap_version, bufferlist& hdrbl,
-			    map<string, bufferlist>& omap, MDSContext *c)
+			    map<string, bufferlist>& omap,
+			    const std::string& last_key, bool streaming,
+			    MDSContext *c)
 {
   // we have more omap keys to fetch!
   object_t oid = get_ondisk_object();
   object_locator_t oloc(mdcache->mds->mdsmap->get_metadata_pool());
-  auto fin = new C_IO_Dir_OMAP_FetchedMore(this, omap_version, c);
+  auto fin = new C_IO_Dir_OMAP_FetchedMore(this, omap_version, streaming, c);
   fin->hdrbl = std::move(hdrbl);
   fin->omap.swap(omap);
   ObjectOperation rd;
-  rd.omap_get_vals(fin->omap.rbegin()->first,
+  rd.omap_get_vals(last_key,
 		   "", /* filter prefix */
 		   g_conf()->mds_dir_keys_per_op,
 		   &fin->omap_more,
@@ -1776,6 +1793,33 @@ void CDir::_omap_fetch_more(version_t omap_version, bufferlist& hdrbl,
 			     new C_OnFinisher(fin, mdcache->mds->finisher));
 }
 
+/**
+ * Whether the dentries of a full fetch can be instantiated batch by batch
+ * as the omap keys arrive. Dirfrags with a damaged header or stale snap
+ * dentries to purge are loaded all at once instead.
+ */
+bool CDir::_omap_can_stream(const bufferlist& hdrbl)
+{
+  if (hdrbl.length() == 0) {
+    return false;
+  }
+
+  fnode_t got_fnode;
+  auto p = hdrbl.cbegin();
+  try {
+    decode(got_fnode, p);
+  } catch (const buffer::error &err) {
+    return false;
+  }
+  if (!p.end()) {
+    return false;
+  }
+
+  snapid_t snap_purged_thru = (get_version() == 0 ?
+    got_fnode.snap_purged_thru : fnode->snap_purged_thru);
+  return snap_purged_thru >= inode->find_snaprealm()->get_last_destroyed();
+}
+
 CDentry *CDir::_load_dentry(
     std::string_view key,
     std::string_view dname,
@@ -1990,11 +2034,13 @@ CDentry *CDir::_load_dentry(
 }
 
 void CDir::_omap_fetched(bufferlist& hdrbl, map<string, bufferlist>& omap,
-			 bool complete, const std::set<string>& keys, int r)
+			 bool complete, const std::set<string>& keys, int r,
+			 bool partial)
 {
   LogChannelRef clog = mdcache->mds->clog;
   dout(10) << "_fetched header " << hdrbl.length() << " bytes "
-	   << omap.size() << " keys for " << *this << dendl;
+	   << omap.size() << " keys for " << *this
+	   << (partial ? " (partial)" : "") << dendl;
 
   ceph_assert(r == 0 || r == -CEPHFS_ENOENT || r == -CEPHFS_ENODATA);
   ceph_assert(is_auth());
@@ -2172,7 +2218,9 @@ void CDir::_omap_fetched(bufferlist& hdrbl, map<string, bufferlist>& omap,
       undef_inodes.push_back(dnl->get_inode());
   }
 
-  if (complete) {
+  if (partial) {
+    // more keys are yet to be fetched
+  } else if (complete) {
     if (!waiting_on_dentry.empty()) {
       for (auto &p : waiting_on_dentry) {
 	std::copy(p.second.begin(), p.second.end(), std::back_inserter(finished));
@@ -2206,7 +2254,7 @@ void CDir::_omap_fetched(bufferlist& hdrbl, map<string, bufferlist>& omap,
   //cache->mds->logger->inc("newin", num_new_inodes_loaded);
 
   // mark complete, !fetching
-  if (complete) {
+  if (complete && !partial) {
     mark_complete();
     state_clear(STATE_FETCHING);
     take_waiting(WAIT_COMPLETE, finished);
@@ -2228,7 +2276,8 @@ void CDir::_omap_fetched(bufferlist& hdrbl, map<string, bufferlist>& omap,
   if (force_dirty && !mdcache->is_readonly())
     log_mark_dirty();
 
-  auth_unpin(this);
+  if (!partial)
+    auth_unpin(this);
 
   if (!finished.empty())
     mdcache->mds->queue_waiters(finished);
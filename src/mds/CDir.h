@@ -655,7 +655,10 @@ protected:
 
   void _omap_fetch(std::set<std::string> *keys, MDSContext *fin=nullptr);
   void _omap_fetch_more(version_t omap_version, bufferlist& hdrbl,
-			std::map<std::string, bufferlist>& omap, MDSContext *fin);
+			std::map<std::string, bufferlist>& omap,
+			const std::string& last_key, bool streaming,
+			MDSContext *fin);
+  bool _omap_can_stream(const ceph::buffer::list& hdrbl);
   CDentry *_load_dentry(
       std::string_view key,
       std::string_view dname,
@@ -672,7 +675,8 @@ protected:
   void go_bad(bool complete);
 
   void _omap_fetched(ceph::buffer::list& hdrbl, std::map<std::string, ceph::buffer::list>& omap,
-		     bool complete, const std::set<std::string>& keys, int r);
+		     bool complete, const std::set<std::string>& keys, int r,
+		     bool partial=false);
 
   // -- commit --
   void _commit(version_t want, int op_prio);
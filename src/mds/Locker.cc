@@ -2386,6 +2386,11 @@ int Locker::issue_caps(CInode *in, Capability *only_cap)
       // issue
       nissued++;
 
+      // the client has to see the caps it was granted before they are
+      // revoked, or it would have nothing to acknowledge
+      if ((pending & ~allowed) && !queued_cap_msgs.empty())
+	flush_cap_grant(in, it->first);
+
       // include caps that clients generally like, while we're at it.
       int likes = in->get_caps_liked();      
       int before = pending;
@@ -2411,14 +2416,10 @@ int Locker::issue_caps(CInode *in, Capability *only_cap)
         if (mds->logger) mds->logger->inc(l_mdss_ceph_cap_op_grant);
       }
 
-      auto m = make_message<MClientCaps>(op, in->ino(),
-					 in->find_snaprealm()->inode->ino(),
-					 cap->get_cap_id(), cap->get_last_seq(),
-					 after, wanted, 0, cap->get_mseq(),
-					 mds->get_osd_epoch_barrier());
-      in->encode_cap_message(m, cap);
-
-      mds->send_message_client_counted(m, cap->get_session());
+      if (g_conf()->mds_coalesce_cap_msgs)
+	queue_cap_msg(in, cap, op);
+      else
+	send_cap_msg(in, cap, op);
     }
 
     if (only_cap)
@@ -2428,6 +2429,102 @@ int Locker::issue_caps(CInode *in, Capability *only_cap)
   return nissued;
 }
 
+void Locker::send_cap_msg(CInode *in, Capability *cap, int op)
+{
+  int wanted = cap->wanted();
+  if (in->get_inode()->nlink == 0)
+    wanted |= CEPH_CAP_LINK_SHARED;
+
+  auto m = make_message<MClientCaps>(op, in->ino(),
+				     in->find_snaprealm()->inode->ino(),
+				     cap->get_cap_id(), cap->get_last_seq(),
+				     cap->pending(), wanted, 0, cap->get_mseq(),
+				     mds->get_osd_epoch_barrier());
+  in->encode_cap_message(m, cap);
+
+  mds->send_message_client_counted(m, cap->get_session());
+}
+
+class C_Locker_FlushCapMsgs : public LockerContext {
+public:
+  explicit C_Locker_FlushCapMsgs(Locker *l) : LockerContext(l) {}
+  void finish(int r) override {
+    locker->flush_queued_cap_msgs();
+  }
+};
+
+/*
+ * Hold back a grant/revoke message until the current dispatch is done.
+ * Messages are built when flushed, so a cap issued several times in the
+ * meantime gets one message with its latest seq and pending caps; a
+ * revoke is still sent as such.
+ */
+void Locker::queue_cap_msg(CInode *in, Capability *cap, int op)
+{
+  if (queued_cap_msgs.empty())
+    mds->queue_waiter(new C_Locker_FlushCapMsgs(this));
+
+  auto em = queued_cap_msgs.emplace(std::piecewise_construct,
+				    std::forward_as_tuple(in),
+				    std::forward_as_tuple());
+  if (em.second)
+    in->get(CInode::PIN_PTRWAITER);
+
+  auto& caps = em.first->second;
+  auto [q, inserted] = caps.emplace(cap->get_client(),
+				    queued_cap_msg_t{cap->get_cap_id(), op});
+  if (inserted)
+    return;
+
+  if (q->second.cap_id != cap->get_cap_id()) {
+    // the cap it was queued for is gone
+    q->second = queued_cap_msg_t{cap->get_cap_id(), op};
+    return;
+  }
+
+  dout(10) << "coalescing cap msg to client." << cap->get_client()
+	   << " on " << *in << dendl;
+  if (mds->logger) mds->logger->inc(l_mdss_ceph_cap_op_coalesced);
+  if (op == CEPH_CAP_OP_REVOKE)
+    q->second.op = op;
+}
+
+void Locker::flush_cap_grant(CInode *in, client_t client)
+{
+  auto p = queued_cap_msgs.find(in);
+  if (p == queued_cap_msgs.end())
+    return;
+  auto q = p->second.find(client);
+  if (q == p->second.end() || q->second.op != CEPH_CAP_OP_GRANT)
+    return;
+
+  Capability *cap = in->get_client_cap(client);
+  if (cap && cap->get_cap_id() == q->second.cap_id)
+    send_cap_msg(in, cap, CEPH_CAP_OP_GRANT);
+
+  p->second.erase(q);
+  if (p->second.empty()) {
+    queued_cap_msgs.erase(p);
+    in->put(CInode::PIN_PTRWAITER);
+  }
+}
+
+void Locker::flush_queued_cap_msgs()
+{
+  auto queued = std::move(queued_cap_msgs);
+  queued_cap_msgs.clear();
+
+  dout(10) << "flush_queued_cap_msgs on " << queued.size() << " inodes" << dendl;
+  for (auto& [in, caps] : queued) {
+    for (auto& [client, q] : caps) {
+      Capability *cap = in->get_client_cap(client);
+      if (cap && cap->get_cap_id() == q.cap_id)
+	send_cap_msg(in, cap, q.op);
+    }
+    in->put(CInode::PIN_PTRWAITER);
+  }
+}
+
 void Locker::issue_truncate(CInode *in)
 {
   dout(7) << "issue_truncate on " << *in << dendl;
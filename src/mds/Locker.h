@@ -258,8 +258,13 @@ private:
   friend class C_Locker_ScatterWB;
   friend class LockerContext;
   friend class LockerLogContext;
+  friend class C_Locker_FlushCapMsgs;
 
   bool any_late_revoking_caps(xlist<Capability*> const &revoking, double timeout) const;
+  void send_cap_msg(CInode *in, Capability *cap, int op);
+  void queue_cap_msg(CInode *in, Capability *cap, int op);
+  void flush_cap_grant(CInode *in, client_t client);
+  void flush_queued_cap_msgs();
   uint64_t calc_new_max_size(const CInode::inode_const_ptr& pi, uint64_t size);
   __u32 get_xattr_total_length(CInode::mempool_xattr_map &xattr);
   void decode_new_xattrs(CInode::mempool_inode *inode,
@@ -269,5 +274,12 @@ private:
   MDSRank *mds;
   MDCache *mdcache;
   xlist<ScatterLock*> updated_filelocks;
+
+  struct queued_cap_msg_t {
+    uint64_t cap_id;
+    int op;
+  };
+  // grant/revoke messages held back until the end of the current dispatch
+  std::map<CInode*, std::map<client_t, queued_cap_msg_t>> queued_cap_msgs;
 };
 #endif
@@ -83,6 +83,10 @@ MDBalancer::MDBalancer(MDSRank *m, Messenger *msgr, MonClient *monc) :
 {
   bal_fragment_dirs = g_conf().get_val<bool>("mds_bal_fragment_dirs");
   bal_fragment_interval = g_conf().get_val<int64_t>("mds_bal_fragment_interval");
+  bal_predictive = g_conf().get_val<bool>("mds_bal_predictive");
+  bal_predict_alpha = g_conf().get_val<double>("mds_bal_predict_alpha");
+  bal_predict_beta = g_conf().get_val<double>("mds_bal_predict_beta");
+  bal_migration_cost = g_conf().get_val<double>("mds_bal_migration_cost");
 }
 
 void MDBalancer::handle_conf_change(const std::set<std::string>& changed, const MDSMap& mds_map)
@@ -93,6 +97,21 @@ void MDBalancer::handle_conf_change(const std::set<std::string>& changed, const
   if (changed.count("mds_bal_fragment_interval")) {
     bal_fragment_interval = g_conf().get_val<int64_t>("mds_bal_fragment_interval");
   }
+  if (changed.count("mds_bal_predictive")) {
+    bal_predictive = g_conf().get_val<bool>("mds_bal_predictive");
+    if (!bal_predictive) {
+      subtree_loads.clear();
+    }
+  }
+  if (changed.count("mds_bal_predict_alpha")) {
+    bal_predict_alpha = g_conf().get_val<double>("mds_bal_predict_alpha");
+  }
+  if (changed.count("mds_bal_predict_beta")) {
+    bal_predict_beta = g_conf().get_val<double>("mds_bal_predict_beta");
+  }
+  if (changed.count("mds_bal_migration_cost")) {
+    bal_migration_cost = g_conf().get_val<double>("mds_bal_migration_cost");
+  }
 }
 
 bool MDBalancer::test_rank_mask(mds_rank_t rank)
@@ -450,6 +469,9 @@ void MDBalancer::send_heartbeat()
   }
   mds_import_map[ mds->get_nodeid() ] = import_map;
 
+  if (bal_predictive) {
+    sample_subtree_loads();
+  }
 
   dout(3) << " epoch " << beat_epoch << " load " << load << dendl;
   for (const auto& [rank, load] : import_map) {
@@ -692,6 +714,7 @@ void MDBalancer::queue_merge(CDir *dir)
 void MDBalancer::prep_rebalance(int beat)
 {
   balance_state_t state;
+  last_state = state;
 
   if (g_conf()->mds_thrash_exports) {
     //we're going to randomly export to all the mds in the cluster
@@ -858,12 +881,14 @@ void MDBalancer::prep_rebalance(int beat)
       }
     }
   }
+  last_state = state;
   try_rebalance(state);
 }
 
 int MDBalancer::mantle_prep_rebalance()
 {
   balance_state_t state;
+  last_state = state;
 
   /* refresh balancer if it has changed */
   if (bal_version != mds->mdsmap->get_balancer()) {
@@ -904,13 +929,14 @@ int MDBalancer::mantle_prep_rebalance()
   else if (ret)
     return ret;
 
+  last_state = state;
   try_rebalance(state);
   return 0;
 }
 
 
 
-void MDBalancer::try_rebalance(balance_state_t& state)
+void MDBalancer::try_rebalance(balance_state_t& state, Formatter *plan)
 {
   if (g_conf()->mds_thrash_exports) {
     dout(5) << "mds_thrash is on; not performing standard rebalance operation!"
@@ -932,14 +958,14 @@ void MDBalancer::try_rebalance(balance_state_t& state)
       continue;  // export pbly already in progress
 
     mds_rank_t from = diri->authority().first;
-    double pop = dir->pop_auth_subtree.meta_load();
+    double pop = get_subtree_load(dir, !plan);
     if (g_conf()->mds_bal_idle_threshold > 0 &&
 	pop < g_conf()->mds_bal_idle_threshold &&
 	diri != mds->mdcache->get_root() &&
 	from != mds->get_nodeid()) {
       dout(5) << " exporting idle (" << pop << ") import " << *dir
 	      << " back to mds." << from << dendl;
-      mds->mdcache->migrator->export_dir_nicely(dir, from);
+      export_subtree(dir, from, pop, plan);
       continue;
     }
 
@@ -985,10 +1011,10 @@ void MDBalancer::try_rebalance(balance_state_t& state)
 	  continue;
 	ceph_assert(dir->inode->authority().first == target);  // cuz that's how i put it in the map, dummy
 
-	if (pop <= amount-have) {
+	if (pop <= amount-have && worth_exporting(dir, pop)) {
 	  dout(7) << "reexporting " << *dir << " pop " << pop
 		  << " back to mds." << target << dendl;
-	  mds->mdcache->migrator->export_dir_nicely(dir, target);
+	  export_subtree(dir, target, pop, plan);
 	  have += pop;
 	  import_from_map.erase(plast);
 	  for (auto q = import_pop_map.equal_range(pop);
@@ -1028,11 +1054,12 @@ void MDBalancer::try_rebalance(balance_state_t& state)
       }
 
       double pop = p->first;
-      if (pop <= amount-have && pop > MIN_REEXPORT) {
+      if (pop <= amount-have && pop > MIN_REEXPORT &&
+	  worth_exporting(dir, pop)) {
 	dout(5) << "reexporting " << *dir << " pop " << pop
 		<< " to mds." << target << dendl;
 	have += pop;
-	mds->mdcache->migrator->export_dir_nicely(dir, target);
+	export_subtree(dir, target, pop, plan);
 	import_pop_map.erase(p++);
       } else {
 	++p;
@@ -1043,6 +1070,8 @@ void MDBalancer::try_rebalance(balance_state_t& state)
   }
 
   set<CDir*> already_exporting;
+  // a dry run must not eat into the time budget of the last real one
+  const time start = plan ? clock::now() : rebalance_time;
 
   for (auto &it : state.targets) {
     mds_rank_t target = it.first;
@@ -1061,17 +1090,19 @@ void MDBalancer::try_rebalance(balance_state_t& state)
 	 p != import_pop_map.rend();
 	 ++p) {
       CDir *dir = p->second;
-      find_exports(dir, amount, &exports, have, already_exporting);
+      find_exports(dir, amount, &exports, have, already_exporting, start,
+		   plan != nullptr);
       if (amount-have < MIN_OFFLOAD)
 	break;
     }
     //fudge = amount - have;
 
     for (const auto& dir : exports) {
+      double pop = get_subtree_load(dir, !plan);
       dout(5) << "   - exporting " << dir->pop_auth_subtree
-	      << " " << dir->pop_auth_subtree.meta_load()
+	      << " " << pop
 	      << " to mds." << target << " " << *dir << dendl;
-      mds->mdcache->migrator->export_dir_nicely(dir, target);
+      export_subtree(dir, target, pop, plan);
     }
   }
 
@@ -1079,14 +1110,135 @@ void MDBalancer::try_rebalance(balance_state_t& state)
   mds->mdcache->show_subtrees();
 }
 
+void MDBalancer::export_subtree(CDir *dir, mds_rank_t target, double pop,
+                                Formatter *plan)
+{
+  if (plan) {
+    plan->open_object_section("export");
+    plan->dump_stream("dirfrag") << dir->dirfrag();
+    plan->dump_string("path", dir->get_path());
+    plan->dump_int("target", target);
+    plan->dump_float("load", pop);
+    plan->close_section();
+    return;
+  }
+  mds->mdcache->migrator->export_dir_nicely(dir, target);
+}
+
+/*
+ * The load to balance with: the subtree's instantaneous popularity, or in
+ * predictive mode the next value of its exponentially smoothed history
+ * (Holt's linear method, one step per balancer epoch).  Without update
+ * (dry runs) the history is left as it is.
+ */
+double MDBalancer::get_subtree_load(CDir *dir, bool update)
+{
+  double load = dir->pop_auth_subtree.meta_load();
+  if (!bal_predictive)
+    return load;
+
+  subtree_load_t h;
+  auto it = subtree_loads.find(dir->dirfrag());
+  if (it == subtree_loads.end()) {
+    h.level = load;
+  } else {
+    h = it->second;
+    if (h.epoch < beat_epoch) {
+      int steps = beat_epoch - h.epoch;
+      double last_level = h.level;
+      h.level = bal_predict_alpha * load +
+                (1.0 - bal_predict_alpha) * (h.level + h.trend * steps);
+      h.trend = bal_predict_beta * (h.level - last_level) / steps +
+                (1.0 - bal_predict_beta) * h.trend;
+    }
+  }
+  h.epoch = beat_epoch;
+  if (update)
+    subtree_loads[dir->dirfrag()] = h;
+  return std::max(0.0, h.level + h.trend);
+}
+
+bool MDBalancer::worth_exporting(CDir *dir, double pop) const
+{
+  if (!bal_predictive)
+    return true;
+
+  // every cached dentry of the dirfrag, and the inodes and client caps
+  // behind its entries, have to be frozen, encoded and handed over to the
+  // importer.  Go by the counts the dirfrag keeps anyway rather than walking
+  // its dentries under mds_lock.
+  uint64_t items = dir->get_num_any();
+  int64_t entries = dir->get_fnode()->fragstat.size();
+  if (entries > 0)
+    items += entries;
+
+  double cost = bal_migration_cost * items;
+  if (pop > cost)
+    return true;
+
+  dout(15) << " predicted load " << pop << " below migration cost " << cost
+	   << ", not exporting " << *dir << dendl;
+  return false;
+}
+
+void MDBalancer::sample_subtree_loads()
+{
+  for (auto& dir : mds->mdcache->get_fullauth_subtrees()) {
+    get_subtree_load(dir);
+    for (elist<CInode*>::iterator it = dir->pop_lru_subdirs.begin_use_current();
+	 !it.end(); ++it) {
+      for (const auto& subdir : (*it)->get_nested_dirfrags()) {
+	if (subdir->is_auth())
+	  get_subtree_load(subdir);
+      }
+    }
+  }
+
+  // forget subtrees that have not been looked at for a while
+  for (auto it = subtree_loads.begin(); it != subtree_loads.end(); ) {
+    if (beat_epoch - it->second.epoch > SUBTREE_LOAD_HISTORY_EPOCHS)
+      it = subtree_loads.erase(it);
+    else
+      ++it;
+  }
+}
+
+int MDBalancer::dump_plan(Formatter *f)
+{
+  f->open_object_section("plan");
+  f->dump_int("epoch", beat_epoch);
+  f->dump_bool("predictive", bal_predictive);
+
+  f->open_array_section("targets");
+  for (const auto& [rank, amount] : last_state.targets) {
+    f->open_object_section("target");
+    f->dump_int("rank", rank);
+    f->dump_float("load", amount);
+    f->close_section();
+  }
+  f->close_section();
+
+  f->open_array_section("exports");
+  if (!last_state.targets.empty()) {
+    balance_state_t state = last_state;
+    try_rebalance(state, f);
+  }
+  f->close_section();
+
+  f->close_section();
+  return 0;
+}
+
 void MDBalancer::find_exports(CDir *dir,
                               double amount,
                               std::vector<CDir*>* exports,
                               double& have,
-                              set<CDir*>& already_exporting)
+                              set<CDir*>& already_exporting,
+                              const time& start,
+                              bool dry_run)
 {
   auto now = clock::now();
-  auto duration = std::chrono::duration<double>(now-rebalance_time).count();
+  auto duration = std::chrono::duration<double>(now-start).count();
   if (duration > 0.1) {
     derr << " balancer runs too long"  << dendl_impl;
     have = amount;
@@ -1133,7 +1285,7 @@ void MDBalancer::find_exports(CDir *dir,
 	continue;  // can't export this right now!
 
       // how popular?
-      double pop = subdir->pop_auth_subtree.meta_load();
+      double pop = get_subtree_load(subdir, !dry_run);
       subdir_sum += pop;
       dout(15) << "   subdir pop " << pop << " " << *subdir << dendl;
 
@@ -1143,7 +1295,7 @@ void MDBalancer::find_exports(CDir *dir,
       }
 
       // lucky find?
-      if (pop > needmin && pop < needmax) {
+      if (pop > needmin && pop < needmax && worth_exporting(subdir, pop)) {
 	exports->push_back(subdir);
 	already_exporting.insert(subdir);
 	have += pop;
@@ -1155,10 +1307,10 @@ void MDBalancer::find_exports(CDir *dir,
 	  bigger_rep.push_back(subdir);
 	else
 	  bigger_unrep.push_back(subdir);
-      } else
+      } else if (worth_exporting(subdir, pop))
 	smaller.insert(pair<double,CDir*>(pop, subdir));
     }
-    if (dfls.size() == num_idle_frags)
+    if (dfls.size() == num_idle_frags && !dry_run)
       in->item_pop_lru.remove_myself();
   }
   dout(15) << "   sum " << subdir_sum << " / " << dir_pop << dendl;
@@ -1184,7 +1336,8 @@ void MDBalancer::find_exports(CDir *dir,
   // apprently not enough; drill deeper into the hierarchy (if non-replicated)
   for (const auto& dir : bigger_unrep) {
     dout(15) << "   descending into " << *dir << dendl;
-    find_exports(dir, amount, exports, have, already_exporting);
+    find_exports(dir, amount, exports, have, already_exporting, start,
+		 dry_run);
     if (have > needmin)
       return;
   }
@@ -1205,7 +1358,8 @@ void MDBalancer::find_exports(CDir *dir,
   // ok fine, drill into replicated dirs
   for (const auto& dir : bigger_rep) {
     dout(7) << "   descending into replicated " << *dir << dendl;
-    find_exports(dir, amount, exports, have, already_exporting);
+    find_exports(dir, amount, exports, have, already_exporting, start,
+		 dry_run);
     if (have > needmin)
       return;
   }
@@ -76,6 +76,12 @@ public:
 
   int dump_loads(Formatter *f, int64_t depth = -1) const;
 
+  /**
+   * Dry run of the last rebalance: dump the exports the balancer would
+   * do for its current targets without migrating anything.
+   */
+  int dump_plan(Formatter *f);
+
 private:
   typedef struct {
     std::map<mds_rank_t, double> targets;
@@ -83,6 +89,13 @@ private:
     std::map<mds_rank_t, double> exported;
   } balance_state_t;
 
+  // smoothed load history of a subtree, one sample per balancer epoch
+  struct subtree_load_t {
+    double level = 0;
+    double trend = 0;
+    int epoch = 0;
+  };
+
   //set up the rebalancing targets for export and do one if the
   //MDSMap is up to date
   void prep_rebalance(int beat);
@@ -96,7 +109,9 @@ private:
                     double amount,
                     std::vector<CDir*>* exports,
                     double& have,
-                    std::set<CDir*>& already_exporting);
+                    std::set<CDir*>& already_exporting,
+                    const time& start,
+                    bool dry_run);
 
   double try_match(balance_state_t &state,
                    mds_rank_t ex, double& maxex,
@@ -116,12 +131,23 @@ private:
    * if it has then do the actual export. Otherwise send off our
    * export targets message again.
    */
-  void try_rebalance(balance_state_t& state);
+  void try_rebalance(balance_state_t& state, Formatter *plan=nullptr);
   bool test_rank_mask(mds_rank_t rank);
 
+  void export_subtree(CDir *dir, mds_rank_t target, double pop,
+                      Formatter *plan);
+  double get_subtree_load(CDir *dir, bool update=true);
+  bool worth_exporting(CDir *dir, double pop) const;
+  void sample_subtree_loads();
+
   bool bal_fragment_dirs;
   int64_t bal_fragment_interval;
+  bool bal_predictive;
+  double bal_predict_alpha;
+  double bal_predict_beta;
+  double bal_migration_cost;
   static const unsigned int AUTH_TREES_THRESHOLD = 5;
+  static const int SUBTREE_LOAD_HISTORY_EPOCHS = 10;
 
   MDSRank *mds;
   Messenger *messenger;
@@ -156,5 +182,10 @@ private:
   // per-epoch state
   double my_load = 0;
   double target_load = 0;
+
+  // targets of the last rebalance, for dry runs
+  balance_state_t last_state;
+
+  std::map<dirfrag_t, subtree_load_t> subtree_loads;
 };
 #endif
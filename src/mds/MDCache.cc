@@ -6784,6 +6784,14 @@ std::pair<bool, uint64_t> MDCache::trim_lru(uint64_t count, expiremap& expiremap
           << " pinned=" << lru.lru_get_num_pinned()
           << dendl;
 
+  // a dirfrag being fetched may already hold the dentries of earlier omap
+  // batches; trimming them would leave it incomplete once the fetch ends
+  auto is_fetching = [](CDentry *dn) {
+    CDir *dir = dn->get_dir();
+    return dn->is_auth() && dir->state_test(CDir::STATE_FETCHING) &&
+           !(dn->get_linkage()->is_null() && dn->is_clean());
+  };
+
   const uint64_t trim_counter_start = trim_counter.get();
   bool throttled = false;
   while (1) {
@@ -6792,7 +6800,7 @@ std::pair<bool, uint64_t> MDCache::trim_lru(uint64_t count, expiremap& expiremap
     CDentry *dn = static_cast<CDentry*>(bottom_lru.lru_expire());
     if (!dn)
       break;
-    if (trim_dentry(dn, expiremap)) {
+    if (is_fetching(dn) || trim_dentry(dn, expiremap)) {
       unexpirables.push_back(dn);
     } else {
       trimmed++;
@@ -6818,7 +6826,7 @@ std::pair<bool, uint64_t> MDCache::trim_lru(uint64_t count, expiremap& expiremap
       // refer to MDCache::standby_trim_segment
       lru.lru_insert_bot(dn);
       break;
-    } else if (trim_dentry(dn, expiremap)) {
+    } else if (is_fetching(dn) || trim_dentry(dn, expiremap)) {
       unexpirables.push_back(dn);
     } else {
       trimmed++;
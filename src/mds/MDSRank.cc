@@ -1076,13 +1076,6 @@ bool MDSRank::_dispatch(const cref_t<Message> &m, bool new_msg)
   }
 
   // hack: thrash exports
-  static utime_t start;
-  utime_t now = ceph_clock_now();
-  if (start == utime_t())
-    start = now;
-  /*double el = now - start;
-  if (el > 30.0 &&
-    el < 60.0)*/
   for (int i=0; i<g_conf()->mds_thrash_exports; i++) {
     set<mds_rank_t> s;
     if (!is_active()) break;
@@ -1148,7 +1141,8 @@ bool MDSRank::_dispatch(const cref_t<Message> &m, bool new_msg)
   }
   */
 
-  update_mlogger();
+  // note: the memory perf counters are refreshed by the MDCache upkeep
+  // thread -- not for every dispatched message
   return true;
 }
 
@@ -2860,6 +2854,9 @@ void MDSRankDispatcher::handle_asok_command(
       dout(10) << "no depth limit when dirfrags dump_load" << dendl;
     }
     r = balancer->dump_loads(f, depth);
+  } else if (command == "balancer plan") {
+    std::lock_guard l(mds_lock);
+    r = balancer->dump_plan(f);
   } else if (command == "dump snaps") {
     std::lock_guard l(mds_lock);
     string server;
@@ -3430,6 +3427,8 @@ void MDSRank::create_logger()
                            "Grant caps", "cgra", PerfCountersBuilder::PRIO_INTERESTING);
     mds_plb.add_u64_counter(l_mdss_ceph_cap_op_trunc, "ceph_cap_op_trunc",
                            "caps truncate notify", "ctru", PerfCountersBuilder::PRIO_INTERESTING);
+    mds_plb.add_u64_counter(l_mdss_ceph_cap_op_coalesced, "ceph_cap_op_coalesced",
+                           "Cap grant/revoke msgs coalesced", "ccoa", PerfCountersBuilder::PRIO_INTERESTING);
     mds_plb.add_u64_counter(l_mdss_ceph_cap_op_flushsnap_ack, "ceph_cap_op_flushsnap_ack",
                            "caps truncate notify", "cfsa", PerfCountersBuilder::PRIO_INTERESTING);
     mds_plb.add_u64_counter(l_mdss_ceph_cap_op_flush_ack, "ceph_cap_op_flush_ack",
@@ -3789,6 +3788,10 @@ const char** MDSRankDispatcher::get_tracked_conf_keys() const
     "mds_bal_fragment_dirs",
     "mds_bal_fragment_interval",
     "mds_bal_fragment_size_max",
+    "mds_bal_migration_cost",
+    "mds_bal_predict_alpha",
+    "mds_bal_predict_beta",
+    "mds_bal_predictive",
     "mds_cache_memory_limit",
     "mds_cache_mid",
     "mds_cache_reservation",
@@ -3813,6 +3816,7 @@ const char** MDSRankDispatcher::get_tracked_conf_keys() const
     "mds_op_history_duration",
     "mds_op_history_size",
     "mds_op_log_threshold",
+    "mds_purge_queue_adaptive_ops",
     "mds_recall_max_decay_rate",
     "mds_recall_warning_decay_rate",
     "mds_request_load_average_decay_rate",
@@ -100,6 +100,7 @@ enum {
   l_mdss_ceph_cap_op_revoke,
   l_mdss_ceph_cap_op_grant,
   l_mdss_ceph_cap_op_trunc,
+  l_mdss_ceph_cap_op_coalesced,
   l_mdss_ceph_cap_op_flushsnap_ack,
   l_mdss_ceph_cap_op_flush_ack,
   l_mdss_handle_client_caps,
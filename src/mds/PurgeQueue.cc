@@ -147,9 +147,11 @@ void PurgeQueue::create_logger()
   pcb.add_u64(l_pq_executing, "pq_executing", "Purge queue tasks in flight");
   pcb.add_u64(l_pq_executing_high_water, "pq_executing_high_water", "Maximum number of executing file purges");
   pcb.add_u64(l_pq_item_in_journal, "pq_item_in_journal", "Purge item left in journal");
+  pcb.add_u64(l_pq_executing_ops_limit, "pq_executing_ops_limit", "Purge queue op limit");
 
   logger.reset(pcb.create_perf_counters());
   g_ceph_context->get_perfcounters_collection()->add(logger.get());
+  logger->set(l_pq_executing_ops_limit, _get_op_limit());
 }
 
 void PurgeQueue::init()
@@ -394,7 +396,7 @@ bool PurgeQueue::_can_consume()
     return false;
   }
 
-  dout(20) << ops_in_flight << "/" << max_purge_ops << " ops, "
+  dout(20) << ops_in_flight << "/" << _get_op_limit() << " ops, "
            << in_flight.size() << "/" << g_conf()->mds_max_purge_files
            << " files" << dendl;
 
@@ -406,9 +408,10 @@ bool PurgeQueue::_can_consume()
     return true;
   }
 
-  if (ops_in_flight >= max_purge_ops) {
+  const uint64_t op_limit = _get_op_limit();
+  if (ops_in_flight >= op_limit) {
     dout(20) << "Throttling on op limit " << ops_in_flight << "/"
-             << max_purge_ops << dendl;
+             << op_limit << dendl;
     return false;
   }
 
@@ -537,9 +540,20 @@ void PurgeQueue::_commit_ops(int r, const std::vector<PurgeItemCommitOp>& ops_ve
           continue;
       }
 
-      filer.purge_range(op.item.ino, &op.item.layout, op.item.snapc,
-                        first_obj, num_obj, ceph::real_clock::now(), op.flags,
-                        gather.new_sub());
+      // a large file is deleted as several ranges in parallel, each
+      // with its own filer_max_purge_ops window
+      uint64_t ranges = std::min<uint64_t>(
+        cct->_conf->mds_purge_file_parallel_ranges,
+        num_obj / std::max<int>(1, cct->_conf->filer_max_purge_ops));
+      uint64_t range_obj = num_obj / std::max<uint64_t>(1, ranges);
+      while (num_obj > 0) {
+        uint64_t n = (num_obj < 2 * range_obj) ? num_obj : range_obj;
+        filer.purge_range(op.item.ino, &op.item.layout, op.item.snapc,
+                          first_obj, n, ceph::real_clock::now(), op.flags,
+                          gather.new_sub());
+        first_obj += n;
+        num_obj -= n;
+      }
     } else if (op.type == PurgeItemCommitOp::PURGE_OP_REMOVE) {
       if (op.item.action == PurgeItem::PURGE_DIR) {
         objecter->remove(op.oid, op.oloc, nullsnapc,
@@ -563,7 +577,8 @@ void PurgeQueue::_commit_ops(int r, const std::vector<PurgeItemCommitOp>& ops_ve
   ceph_assert(gather.has_subs());
 
   gather.set_finisher(new C_OnFinisher(
-	              new LambdaContext([this, expire_to](int r) {
+	              new LambdaContext([this, expire_to,
+				         start=mono_clock::now()](int r) {
     std::lock_guard l(lock);
 
     if (r == -CEPHFS_EBLOCKLISTED) {
@@ -572,6 +587,13 @@ void PurgeQueue::_commit_ops(int r, const std::vector<PurgeItemCommitOp>& ops_ve
       return;
     }
 
+    auto iter = in_flight.find(expire_to);
+    if (iter != in_flight.end()) {
+      double latency = std::chrono::duration<double>(
+        mono_clock::now() - start).count();
+      _adapt_op_limit(latency / std::max<uint32_t>(1, _calculate_ops(iter->second)));
+    }
+
     _execute_item_complete(expire_to);
     _consume();
 
@@ -772,10 +794,44 @@ void PurgeQueue::update_op_limit(const MDSMap &mds_map)
   if (cct->_conf->mds_max_purge_ops) {
     max_purge_ops = std::min(max_purge_ops, cct->_conf->mds_max_purge_ops);
   }
+  // MDSRank calls this before the perf counters are created
+  if (logger) {
+    logger->set(l_pq_executing_ops_limit, _get_op_limit());
+  }
+}
+
+uint64_t PurgeQueue::_get_op_limit() const
+{
+  if (draining || !cct->_conf->mds_purge_queue_adaptive_ops) {
+    return max_purge_ops;
+  }
+  return op_limiter.get(max_purge_ops);
+}
+
+void PurgeQueue::_adapt_op_limit(double op_latency)
+{
+  if (!cct->_conf->mds_purge_queue_adaptive_ops) {
+    return;
+  }
+
+  uint64_t prev = _get_op_limit();
+  if (op_limiter.update(op_latency, max_purge_ops)) {
+    dout(10) << "op limit " << prev << " -> " << _get_op_limit()
+             << " (max " << max_purge_ops << "), avg op latency "
+             << op_limiter.get_avg_latency() << " min "
+             << op_limiter.get_min_latency() << dendl;
+    logger->set(l_pq_executing_ops_limit, _get_op_limit());
+  }
 }
 
 void PurgeQueue::handle_conf_change(const std::set<std::string>& changed, const MDSMap& mds_map)
 {
+  if (changed.count("mds_purge_queue_adaptive_ops")) {
+    std::lock_guard l(lock);
+    op_limiter.reset();
+    logger->set(l_pq_executing_ops_limit, _get_op_limit());
+  }
+
   if (changed.count("mds_max_purge_ops")
       || changed.count("mds_max_purge_ops_per_pg")) {
     update_op_limit(mds_map);
@@ -850,3 +906,54 @@ std::string_view PurgeItem::get_type_str() const
     return "UNKNOWN";
   }
 }
+
+void PurgeOpLimiter::reset()
+{
+  limit = 0;
+  min_latency = avg_latency = 0;
+  completions = 0;
+}
+
+uint64_t PurgeOpLimiter::get(uint64_t ceiling) const
+{
+  if (limit == 0) {
+    return ceiling;
+  }
+  return std::min(limit, ceiling);
+}
+
+/*
+ * Purge is background work: give way quickly when the OSDs start queueing
+ * (op latency well above the best seen, likely behind client I/O) and
+ * reclaim the ops gradually, in proportion to the current limit, when
+ * they drain.  The best-seen latency is raised a little every window so
+ * that a cluster which became slower for good stops looking congested.
+ */
+bool PurgeOpLimiter::update(double op_latency, uint64_t ceiling)
+{
+  if (min_latency == 0 || op_latency < min_latency) {
+    min_latency = op_latency;
+  }
+  if (avg_latency == 0) {
+    avg_latency = op_latency;
+  } else {
+    avg_latency += (op_latency - avg_latency) / 8;
+  }
+
+  if (++completions < WINDOW) {
+    return false;
+  }
+  completions = 0;
+
+  const uint64_t prev = get(ceiling);
+  uint64_t next = prev;
+  if (avg_latency > min_latency * 2) {
+    next = std::max<uint64_t>(1, (next * 3) / 4);
+  } else if (next < ceiling) {
+    next = std::min(ceiling, next + std::max<uint64_t>(1, next / 8));
+  }
+  min_latency *= 1.05;
+
+  limit = next;
+  return next != prev;
+}
@@ -91,6 +91,7 @@ enum {
   l_pq_executing_high_water,
   l_pq_executed,
   l_pq_item_in_journal,
+  l_pq_executing_ops_limit,
   l_pq_last
 };
 
@@ -116,6 +117,36 @@ public:
   object_locator_t oloc;
 };
 
+/**
+ * Purge op limit driven by the latency of individual RADOS ops (a purge
+ * item's latency divided by its op count).  The ceiling follows the PG
+ * count and the MDS map, so it is passed in by the caller rather than
+ * held here.  A limit of 0 means nothing has been adapted yet.
+ */
+class PurgeOpLimiter
+{
+public:
+  // completions per re-evaluation
+  static constexpr unsigned WINDOW = 16;
+
+  void reset();
+
+  uint64_t get(uint64_t ceiling) const;
+  double get_avg_latency() const { return avg_latency; }
+  double get_min_latency() const { return min_latency; }
+
+  /**
+   * @return true if the limit changed
+   */
+  bool update(double op_latency, uint64_t ceiling);
+
+private:
+  uint64_t limit = 0;
+  double min_latency = 0;
+  double avg_latency = 0;
+  unsigned completions = 0;
+};
+
 /**
  * A persistent queue of PurgeItems.  This class both writes and reads
  * to the queue.  There is one of these per MDS rank.
@@ -183,6 +214,8 @@ private:
   uint32_t _calculate_ops(const PurgeItem &item) const;
 
   bool _can_consume();
+  uint64_t _get_op_limit() const;
+  void _adapt_op_limit(double op_latency);
 
   // recover the journal write_pos (drop any partial written entry)
   void _recover();
@@ -228,6 +261,9 @@ private:
   // Dynamic op limit per MDS based on PG count
   uint64_t max_purge_ops = 0;
 
+  // Op limit lowered on rising purge op latency (mds_purge_queue_adaptive_ops)
+  PurgeOpLimiter op_limiter;
+
   // How many bytes were remaining when drain() was first called,
   // used for indicating progress.
   uint64_t drain_initial = 0;
@@ -72,6 +72,19 @@ public:
       const auto myaddrs = messenger->get_myaddrs();
       return objecter->with_osdmap([&](const OSDMap& o) {return o.is_blocklisted(myaddrs);});
     }
+    bool statx_many_use_readdir(const char *relpath, unsigned nr_pending,
+                                const UserPerm& perms) {
+      RWRef_t mref_reader(mount_state, CLIENT_MOUNTING);
+      if (!mref_reader.is_state_satisfied()) {
+        return false;
+      }
+      std::scoped_lock l(client_lock);
+      InodeRef in;
+      filepath path(relpath);
+      int r = path_walk(path, &in, perms);
+      ceph_assert(r == 0);
+      return _statx_many_use_readdir(in.get(), nr_pending);
+    }
     bool check_unknown_reclaim_flag(uint32_t flag) {
       RWRef_t mref_reader(mount_state, CLIENT_MOUNTING);
       if (!mref_reader.is_state_satisfied()) {
@@ -14,6 +14,7 @@
 
 #include <iostream>
 #include <errno.h>
+#include <fmt/format.h>
 #include "TestClient.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -43,3 +44,53 @@ TEST_F(TestClient, CheckNegativeReclaimFlagUnmasked) {
 TEST_F(TestClient, CheckNegativeReclaimFlag) {
   ASSERT_EQ(client->check_unknown_reclaim_flag(-1), true);
 }
+
+TEST_F(TestClient, StatxManyReaddirRatio) {
+  auto dir = fmt::format("{}_{}", ::testing::UnitTest::GetInstance()->current_test_info()->name(), getpid());
+  ASSERT_EQ(0, client->mkdir(dir.c_str(), 0777, myperm));
+  const int nr_files = 64;
+  for (int i = 0; i < nr_files; i++) {
+    auto file = fmt::format("{}/file_{}", dir, i);
+    int fd = client->open(file.c_str(), O_CREAT|O_WRONLY, myperm, 0666);
+    ASSERT_LE(0, fd);
+    ASSERT_EQ(0, client->close(fd));
+  }
+
+  // start over with an empty cache and the directory stats of the MDS
+  client->unmount();
+  TearDown();
+  SetUp();
+  client->mount("/", myperm, true);
+
+  auto& conf = g_ceph_context->_conf;
+  conf.set_val("client_statx_many_readdir_min", "4");
+  conf.set_val("client_statx_many_readdir_ratio", "0.1");
+  conf.apply_changes(nullptr);
+
+  // too few names to list the directory at all
+  ASSERT_FALSE(client->statx_many_use_readdir(dir.c_str(), 3, myperm));
+  // enough names, but a small share of the directory: look them up
+  ASSERT_FALSE(client->statx_many_use_readdir(dir.c_str(), 4, myperm));
+  // at least a tenth of the directory: list it
+  ASSERT_TRUE(client->statx_many_use_readdir(dir.c_str(), 7, myperm));
+  ASSERT_TRUE(client->statx_many_use_readdir(dir.c_str(), nr_files, myperm));
+
+  conf.set_val("client_statx_many_readdir_ratio", "0.5");
+  conf.apply_changes(nullptr);
+  ASSERT_FALSE(client->statx_many_use_readdir(dir.c_str(), 16, myperm));
+  ASSERT_TRUE(client->statx_many_use_readdir(dir.c_str(), 32, myperm));
+
+  conf.set_val("client_statx_many_readdir_min", "0");
+  conf.apply_changes(nullptr);
+  ASSERT_FALSE(client->statx_many_use_readdir(dir.c_str(), nr_files, myperm));
+
+  conf.rm_val("client_statx_many_readdir_min");
+  conf.rm_val("client_statx_many_readdir_ratio");
+  conf.apply_changes(nullptr);
+
+  for (int i = 0; i < nr_files; i++) {
+    auto file = fmt::format("{}/file_{}", dir, i);
+    ASSERT_EQ(0, client->unlink(file.c_str(), myperm));
+  }
+  ASSERT_EQ(0, client->rmdir(dir.c_str(), myperm));
+}
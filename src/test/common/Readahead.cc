@@ -130,3 +130,68 @@ TEST(Readahead, alignment) {
   ASSERT_RA(1400, 300, r.update(1290, 10, Readahead::NO_LIMIT)); // internal readahead size 320
   ASSERT_RA(0, 0, r.update(1300, 10, Readahead::NO_LIMIT));
 }
+
+TEST(Readahead, interleaved_streams) {
+  Readahead r;
+  r.set_trigger_requests(2);
+  r.set_max_streams(2);
+  ASSERT_RA(0, 0, r.update(1000, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(0, 0, r.update(5000, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(0, 0, r.update(1010, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(0, 0, r.update(5010, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(1030, 20, r.update(1020, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(5030, 20, r.update(5020, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(1050, 40, r.update(1030, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(5050, 40, r.update(5030, 10, Readahead::NO_LIMIT));
+}
+
+TEST(Readahead, reverse) {
+  Readahead r;
+  r.set_trigger_requests(2);
+  r.set_detect_patterns(true);
+  ASSERT_RA(0, 0, r.update(1090, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(0, 0, r.update(1080, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(1050, 20, r.update(1070, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(1010, 40, r.update(1060, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(0, 0, r.update(1050, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(0, 0, r.update(1040, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(930, 80, r.update(1030, 10, Readahead::NO_LIMIT));
+}
+
+TEST(Readahead, reverse_not_detected) {
+  Readahead r;
+  r.set_trigger_requests(2);
+  ASSERT_RA(0, 0, r.update(1090, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(0, 0, r.update(1080, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(0, 0, r.update(1070, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(0, 0, r.update(1060, 10, Readahead::NO_LIMIT));
+}
+
+TEST(Readahead, strided) {
+  Readahead r;
+  r.set_trigger_requests(2);
+  r.set_detect_patterns(true);
+  ASSERT_RA(0, 0, r.update(1000, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(0, 0, r.update(1100, 10, Readahead::NO_LIMIT));
+
+  std::vector<Readahead::extent_t> ra;
+  r.update(1200, 10, Readahead::NO_LIMIT, &ra);
+  ASSERT_EQ(2u, ra.size());
+  ASSERT_EQ(Readahead::extent_t(1300, 10), ra[0]);
+  ASSERT_EQ(Readahead::extent_t(1400, 10), ra[1]);
+
+  ra.clear();
+  r.update(1300, 10, Readahead::NO_LIMIT, &ra);
+  ASSERT_TRUE(ra.empty());
+
+  ra.clear();
+  r.update(1400, 10, Readahead::NO_LIMIT, &ra);
+  ASSERT_EQ(4u, ra.size());
+  ASSERT_EQ(Readahead::extent_t(1500, 10), ra[0]);
+  ASSERT_EQ(Readahead::extent_t(1800, 10), ra[3]);
+
+  ASSERT_RA(0, 0, r.update(1500, 10, Readahead::NO_LIMIT));
+  ASSERT_RA(0, 0, r.update(1600, 10, Readahead::NO_LIMIT));
+  // the single extent interface covers the whole strided range
+  ASSERT_RA(1900, 710, r.update(1700, 10, Readahead::NO_LIMIT));
+}
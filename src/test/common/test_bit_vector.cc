@@ -306,3 +306,133 @@ TYPED_TEST(BitVectorTest, iterator) {
     ASSERT_EQ(offset % radix, *it);
   }
 }
+
+TYPED_TEST(BitVectorTest, find_first_not_of) {
+  typename TestFixture::bit_vector_t bit_vector;
+
+  uint64_t radix = 1 << bit_vector.BIT_COUNT;
+  uint64_t size = 12345;
+
+  // create fragmented in-memory bufferlist layout
+  uint64_t resize = 0;
+  while (resize < size) {
+    resize = std::min<uint64_t>(resize + 1000, size);
+    bit_vector.resize(resize);
+  }
+
+  ASSERT_EQ(size, bit_vector.find_first_not_of(0, 0));
+  ASSERT_EQ(0U, bit_vector.find_first_not_of(radix - 1, 0));
+  ASSERT_EQ(size, bit_vector.find_first_not_of(0, size));
+
+  std::vector<uint64_t> offsets = {0, 3, 4, 1023, 4096, 9999, size - 1};
+  for (auto offset : offsets) {
+    bit_vector[offset] = radix - 1;
+  }
+  uint64_t expected = 0;
+  for (auto offset : offsets) {
+    ASSERT_EQ(offset, bit_vector.find_first_not_of(0, expected));
+    expected = offset + 1;
+  }
+  ASSERT_EQ(size, bit_vector.find_first_not_of(0, expected));
+}
+
+TYPED_TEST(BitVectorTest, set_range) {
+  typename TestFixture::bit_vector_t bit_vector;
+
+  uint64_t radix = 1 << bit_vector.BIT_COUNT;
+  size_t size = 2357;
+  bit_vector.resize(size);
+
+  std::vector<uint64_t> ref(size);
+  for (uint64_t i = 0; i < 100; ++i) {
+    uint64_t offset = rand() % size;
+    uint64_t length = rand() % (size - offset + 1);
+    uint64_t value = rand() % radix;
+    bit_vector.set_range(offset, length, value);
+    std::fill(ref.begin() + offset, ref.begin() + offset + length, value);
+
+    for (uint64_t j = 0; j < size; ++j) {
+      ASSERT_EQ(ref[j], bit_vector[j]);
+    }
+  }
+}
+
+TYPED_TEST(BitVectorTest, set_range_data_crc) {
+  typename TestFixture::bit_vector_t bit_vector1;
+  typename TestFixture::bit_vector_t bit_vector2;
+
+  // small enough for the data to be kept in a single buffer
+  uint64_t elements_per_byte = 8 / bit_vector1.BIT_COUNT;
+  uint64_t size = bit_vector1.BLOCK_SIZE * elements_per_byte;
+  bit_vector1.resize(size);
+
+  uint64_t data_byte_offset;
+  uint64_t object_byte_offset;
+  uint64_t byte_length;
+  bit_vector1.get_data_extents(0, size, &data_byte_offset,
+                               &object_byte_offset, &byte_length);
+
+  // decoding caches the block crc on the buffer
+  bufferlist data;
+  bit_vector1.encode_data(data, data_byte_offset, byte_length);
+  auto data_it = data.cbegin();
+  bit_vector1.decode_data(data_it, data_byte_offset);
+
+  bit_vector1.set_range(1, size - 2, 1);
+
+  bufferlist bl;
+  bit_vector1.encode(bl);
+  auto bl_it = bl.cbegin();
+  ASSERT_NO_THROW(bit_vector2.decode(bl_it));
+  ASSERT_EQ(size, bit_vector2.size());
+  for (uint64_t i = 0; i < size; ++i) {
+    ASSERT_EQ(i == 0 || i == size - 1 ? 0 : 1, bit_vector2[i]);
+  }
+}
+
+TYPED_TEST(BitVectorTest, transform) {
+  typename TestFixture::bit_vector_t bit_vector1;
+  typename TestFixture::bit_vector_t bit_vector2;
+
+  uint64_t radix = 1 << bit_vector1.BIT_COUNT;
+  size_t size = 2357;
+  bit_vector1.resize(size);
+  bit_vector2.resize(size);
+
+  std::vector<uint64_t> ref1(size);
+  std::vector<uint64_t> ref2(size);
+  for (size_t i = 0; i < size; ++i) {
+    ref1[i] = rand() % radix;
+    bit_vector1[i] = ref1[i];
+    ref2[i] = rand() % radix;
+    bit_vector2[i] = ref2[i];
+  }
+
+  // round-trip to create a fragmented in-memory bufferlist layout
+  bufferlist bl;
+  bit_vector2.encode(bl);
+  auto bl_it = bl.cbegin();
+  bit_vector2.decode(bl_it);
+
+  uint64_t offset = 17;
+  uint64_t length = size - 42;
+  bit_vector1.transform(
+    bit_vector2, offset, length,
+    [](uint64_t word, uint64_t other_word) { return word ^ other_word; });
+  for (size_t i = 0; i < size; ++i) {
+    uint64_t expected = ref1[i];
+    if (i >= offset && i < offset + length) {
+      expected ^= ref2[i];
+    }
+    ASSERT_EQ(expected, bit_vector1[i]);
+  }
+
+  bit_vector1.transform(0, size, [](uint64_t word) { return ~word; });
+  for (size_t i = 0; i < size; ++i) {
+    uint64_t expected = ref1[i];
+    if (i >= offset && i < offset + length) {
+      expected ^= ref2[i];
+    }
+    ASSERT_EQ(~expected & (radix - 1), bit_vector1[i]);
+  }
+}
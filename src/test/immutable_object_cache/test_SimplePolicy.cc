@@ -233,3 +233,23 @@ TEST_F(TestSimplePolicy, test_evict_list_10) {
     m_promoted_lru.erase(m_promoted_lru.begin());
   }
 }
+
+TEST_F(TestSimplePolicy, test_promote_min_misses) {
+  SimplePolicy policy(g_ceph_context, m_cache_size, 128, 0.9, 3);
+
+  ASSERT_EQ(OBJ_CACHE_SKIP, policy.lookup_object("cold_file"));
+  ASSERT_EQ(OBJ_CACHE_NONE, policy.get_status("cold_file"));
+  ASSERT_EQ(OBJ_CACHE_SKIP, policy.lookup_object("cold_file"));
+  ASSERT_EQ(OBJ_CACHE_NONE, policy.get_status("cold_file"));
+  ASSERT_EQ(0U, policy.get_promoting_entry_num());
+
+  // admitted on the third miss
+  ASSERT_EQ(OBJ_CACHE_NONE, policy.lookup_object("cold_file"));
+  ASSERT_EQ(OBJ_CACHE_SKIP, policy.get_status("cold_file"));
+  ASSERT_EQ(1U, policy.get_promoting_entry_num());
+
+  policy.update_status("cold_file", OBJ_CACHE_PROMOTED, 1);
+  ASSERT_EQ(OBJ_CACHE_PROMOTED, policy.lookup_object("cold_file"));
+  ASSERT_EQ(1U, policy.get_promoted_entry_num());
+  policy.evict_entry("cold_file");
+}
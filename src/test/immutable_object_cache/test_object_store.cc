@@ -3,6 +3,7 @@
 
 #include <filesystem>
 #include <iostream>
+#include <thread>
 #include <unistd.h>
 
 
@@ -75,6 +76,19 @@ public:
                                             obj_name, true, cache_path);
   }
 
+  int write_cache_file(const std::string& cache_file_name, bufferlist data) {
+    return m_object_cache_store->write_cache_file(cache_file_name, data);
+  }
+
+  int evict_content_file(const std::string& cache_file_name) {
+    return m_object_cache_store->evict_content_file(cache_file_name);
+  }
+
+  std::string get_data_file_path(const std::string& cache_file_name) {
+    return m_object_cache_store->get_cache_file_path(
+      m_object_cache_store->get_data_file_name(cache_file_name));
+  }
+
   void TearDown() override {
     if(m_test_rados)
       delete m_test_rados;
@@ -97,3 +111,79 @@ TEST_F(TestObjectStore, test_1) {
 
   shutdown_object_cache_store();
 }
+
+TEST_F(TestObjectStore, DedupSharedContent) {
+  ASSERT_EQ(0, m_test_rados->conf_set("immutable_object_cache_dedup", "true"));
+  create_object_cache_store(1000);
+  fs::remove_all(test_cache_path);
+  init_object_cache_store(m_temp_pool_name, m_temp_volume_name, 1000, true);
+
+  bufferlist data;
+  data.append(std::string(4096, 'a'));
+  bufferlist other_data;
+  other_data.append(std::string(4096, 'b'));
+
+  ASSERT_EQ(0, write_cache_file("ns:1:2:obj1", data));
+  ASSERT_EQ(0, write_cache_file("ns:1:2:obj2", data));
+  ASSERT_EQ(0, write_cache_file("ns:1:2:obj3", other_data));
+
+  // identical objects share a single content file
+  std::string path = get_data_file_path("ns:1:2:obj1");
+  ASSERT_EQ(path, get_data_file_path("ns:1:2:obj2"));
+  ASSERT_NE(path, get_data_file_path("ns:1:2:obj3"));
+  ASSERT_TRUE(fs::exists(path));
+
+  // the content file outlives all but the last reference
+  ASSERT_EQ(0, evict_content_file("ns:1:2:obj1"));
+  ASSERT_TRUE(fs::exists(path));
+  ASSERT_EQ(path, get_data_file_path("ns:1:2:obj2"));
+
+  ASSERT_EQ(0, evict_content_file("ns:1:2:obj2"));
+  ASSERT_FALSE(fs::exists(path));
+  ASSERT_EQ(-ENOENT, evict_content_file("ns:1:2:obj2"));
+  ASSERT_TRUE(fs::exists(get_data_file_path("ns:1:2:obj3")));
+
+  // content which was evicted entirely is written anew
+  ASSERT_EQ(0, write_cache_file("ns:1:2:obj1", data));
+  ASSERT_EQ(path, get_data_file_path("ns:1:2:obj1"));
+  ASSERT_TRUE(fs::exists(path));
+
+  ASSERT_EQ(0, evict_content_file("ns:1:2:obj1"));
+  ASSERT_EQ(0, evict_content_file("ns:1:2:obj3"));
+  shutdown_object_cache_store();
+}
+
+TEST_F(TestObjectStore, DedupEvictRacingPromote) {
+  ASSERT_EQ(0, m_test_rados->conf_set("immutable_object_cache_dedup", "true"));
+  create_object_cache_store(1000);
+  fs::remove_all(test_cache_path);
+  init_object_cache_store(m_temp_pool_name, m_temp_volume_name, 1000, true);
+
+  bufferlist data;
+  data.append(std::string(4096, 'a'));
+
+  // two objects with the same content are promoted and evicted over and
+  // over: once a promotion returned, its content file must be in place
+  // until that very object is evicted
+  std::atomic<int> failures{0};
+  auto promote_and_evict = [&](const std::string& cache_file_name) {
+    for (int i = 0; i < 1000; ++i) {
+      if (write_cache_file(cache_file_name, data) < 0 ||
+          !fs::exists(get_data_file_path(cache_file_name)) ||
+          evict_content_file(cache_file_name) < 0) {
+        ++failures;
+      }
+    }
+  };
+  std::thread thread1(promote_and_evict, "ns:1:2:obj1");
+  std::thread thread2(promote_and_evict, "ns:1:2:obj2");
+  thread1.join();
+  thread2.join();
+  ASSERT_EQ(0, failures);
+
+  // nothing is left behind, neither content nor temporary files
+  for (auto& p : fs::recursive_directory_iterator(test_cache_path)) {
+    ASSERT_TRUE(p.is_directory()) << p.path();
+  }
+  shutdown_object_cache_store();
+}
@@ -129,6 +129,12 @@ public:
     bl.append(payload);
     return std::make_pair(future, bl);
   }
+
+  uint64_t get_object_version(const std::string &oid) {
+    bufferlist bl;
+    EXPECT_LE(0, m_ioctx.read(oid, bl, 1, 0));
+    return m_ioctx.get_last_version();
+  }
 };
 
 TEST_F(TestObjectRecorder, Append) {
@@ -362,6 +368,63 @@ TEST_F(TestObjectRecorder, FlushFuture) {
   ASSERT_EQ(0, cond.wait());
 }
 
+TEST_F(TestObjectRecorder, FlushFutureGroupCommit) {
+  std::string oid = get_temp_oid();
+  ASSERT_EQ(0, create(oid));
+  ASSERT_EQ(0, client_register(oid));
+  auto metadata = create_metadata(oid);
+  ASSERT_EQ(0, init_metadata(metadata));
+
+  ceph::mutex lock = ceph::make_mutex("object_recorder_lock");
+  ObjectRecorderFlusher flusher(m_ioctx, m_work_queue, 0, 0, 0, 1);
+  auto object = flusher.create_object(oid, 24, &lock);
+  lock.lock();
+  object->set_group_commit(true);
+  lock.unlock();
+
+  journal::AppendBuffer append_buffer1 = create_append_buffer(234, 123,
+                                                              "payload");
+  journal::AppendBuffer append_buffer2 = create_append_buffer(234, 124,
+                                                              "payload");
+  journal::AppendBuffer append_buffer3 = create_append_buffer(234, 125,
+                                                              "payload");
+
+  // request the flushes up front so that each append below is flushed as
+  // soon as it is attached
+  object->flush(append_buffer1.first);
+  object->flush(append_buffer2.first);
+  object->flush(append_buffer3.first);
+
+  C_SaferCond cond1;
+  append_buffer1.first->wait(&cond1);
+  C_SaferCond cond2;
+  append_buffer2.first->wait(&cond2);
+  C_SaferCond cond3;
+  append_buffer3.first->wait(&cond3);
+
+  uint64_t version = get_object_version(oid);
+
+  // the completion of the first append cannot be processed while the lock
+  // is held, so the flushes of the later appends have to be deferred
+  journal::AppendBuffers append_buffers;
+  lock.lock();
+  append_buffers = {append_buffer1};
+  ASSERT_FALSE(object->append(std::move(append_buffers)));
+  append_buffers = {append_buffer2};
+  ASSERT_FALSE(object->append(std::move(append_buffers)));
+  append_buffers = {append_buffer3};
+  ASSERT_FALSE(object->append(std::move(append_buffers)));
+  lock.unlock();
+
+  ASSERT_EQ(0, cond1.wait());
+  ASSERT_EQ(0, cond2.wait());
+  ASSERT_EQ(0, cond3.wait());
+  ASSERT_EQ(0U, object->get_pending_appends());
+
+  // one append for the first entry, one for the two coalesced flushes
+  ASSERT_EQ(version + 2, get_object_version(oid));
+}
+
 TEST_F(TestObjectRecorder, FlushDetachedFuture) {
   std::string oid = get_temp_oid();
   ASSERT_EQ(0, create(oid));
@@ -2760,6 +2760,81 @@ TEST(LibCephFS, StatxatATFDCWD) {
   ceph_shutdown(cmount);
 }
 
+TEST(LibCephFS, StatxMany) {
+  struct ceph_mount_info *cmount;
+  ASSERT_EQ(ceph_create(&cmount, NULL), 0);
+  ASSERT_EQ(ceph_conf_read_file(cmount, NULL), 0);
+  ASSERT_EQ(0, ceph_conf_parse_env(cmount, NULL));
+  // list the directory as soon as two names are not cached
+  ASSERT_EQ(0, ceph_conf_set(cmount, "client_statx_many_readdir_min", "2"));
+  ASSERT_EQ(ceph_mount(cmount, NULL), 0);
+
+  char dir_path[64];
+  sprintf(dir_path, "/statx_many_%d", getpid());
+  ASSERT_EQ(0, ceph_mkdir(cmount, dir_path, 0755));
+
+  const int nr_files = 32;
+  std::vector<std::string> names;
+  for (int i = 0; i < nr_files; i++) {
+    names.push_back("file_" + std::to_string(i));
+    std::string path = std::string(dir_path) + "/" + names.back();
+    int fd = ceph_open(cmount, path.c_str(), O_WRONLY|O_CREAT, 0666);
+    ASSERT_LE(0, fd);
+    ASSERT_EQ(i, ceph_write(cmount, fd, std::string(i, 'x').c_str(), i, 0));
+    ASSERT_EQ(0, ceph_close(cmount, fd));
+  }
+  names.push_back("subdir");
+  ASSERT_EQ(0, ceph_mkdir(cmount, (std::string(dir_path) + "/subdir").c_str(), 0755));
+  names.push_back("nonexistent");
+  names.push_back("subdir/..");
+  names.push_back("file_3");
+
+  std::vector<const char*> relpaths;
+  for (auto& name : names) {
+    relpaths.push_back(name.c_str());
+  }
+  std::vector<struct ceph_statx> stx(names.size());
+  std::vector<int> results(names.size(), 1);
+
+  // remount so that nothing is cached
+  ceph_shutdown(cmount);
+  ASSERT_EQ(ceph_create(&cmount, NULL), 0);
+  ASSERT_EQ(ceph_conf_read_file(cmount, NULL), 0);
+  ASSERT_EQ(0, ceph_conf_parse_env(cmount, NULL));
+  ASSERT_EQ(0, ceph_conf_set(cmount, "client_statx_many_readdir_min", "2"));
+  ASSERT_EQ(ceph_mount(cmount, NULL), 0);
+
+  int fd = ceph_open(cmount, dir_path, O_DIRECTORY | O_RDONLY, 0);
+  ASSERT_LE(0, fd);
+  for (int pass = 0; pass < 2; pass++) {
+    // the second pass is served from the cache
+    ASSERT_EQ(0, ceph_statx_many(cmount, fd, relpaths.data(), relpaths.size(),
+				 stx.data(), results.data(),
+				 CEPH_STATX_MODE | CEPH_STATX_SIZE, 0));
+    for (int i = 0; i < nr_files; i++) {
+      ASSERT_EQ(0, results[i]);
+      ASSERT_EQ(S_IFREG, stx[i].stx_mode & S_IFMT);
+      ASSERT_EQ((uint64_t)i, stx[i].stx_size);
+    }
+    ASSERT_EQ(0, results[nr_files]);
+    ASSERT_EQ(S_IFDIR, stx[nr_files].stx_mode & S_IFMT);
+    ASSERT_EQ(-CEPHFS_ENOENT, results[nr_files + 1]);
+    ASSERT_EQ(0, results[nr_files + 2]);
+    ASSERT_EQ(S_IFDIR, stx[nr_files + 2].stx_mode & S_IFMT);
+    ASSERT_EQ(0, results[nr_files + 3]);
+    ASSERT_EQ(3u, stx[nr_files + 3].stx_size);
+  }
+  ASSERT_EQ(0, ceph_close(cmount, fd));
+
+  for (int i = 0; i < nr_files; i++) {
+    ASSERT_EQ(0, ceph_unlink(cmount, (std::string(dir_path) + "/" + names[i]).c_str()));
+  }
+  ASSERT_EQ(0, ceph_rmdir(cmount, (std::string(dir_path) + "/subdir").c_str()));
+  ASSERT_EQ(0, ceph_rmdir(cmount, dir_path));
+
+  ceph_shutdown(cmount);
+}
+
 TEST(LibCephFS, Fdopendir) {
   pid_t mypid = getpid();
 
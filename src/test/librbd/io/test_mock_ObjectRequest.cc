@@ -125,6 +125,8 @@ struct Mock {
   MOCK_METHOD6(read_parent,
                void(librbd::MockTestImageCtx *, uint64_t, ReadExtents*,
                     librados::snap_t, const ZTracer::Trace &, Context*));
+  MOCK_METHOD4(trigger_copyup, bool(librbd::MockTestImageCtx *, uint64_t,
+                                    IOContext, Context*));
 };
 
 Mock *Mock::s_instance = nullptr;
@@ -139,6 +141,13 @@ template<> void read_parent(
                                 on_finish);
 }
 
+template<> bool trigger_copyup(
+    librbd::MockTestImageCtx *image_ctx, uint64_t object_no,
+    IOContext io_context, Context* on_finish) {
+  return Mock::s_instance->trigger_copyup(image_ctx, object_no, io_context,
+                                          on_finish);
+}
+
 } // namespace util
 
 } // namespace io
@@ -261,6 +270,17 @@ struct TestMockIoObjectRequest : public TestMockFixture {
       .WillOnce(WithArg<5>(CompleteContext(r, static_cast<asio::ContextWQ*>(nullptr))));
   }
 
+  void expect_trigger_copyup(MockUtils &mock_utils, uint64_t object_no,
+                             bool r) {
+    EXPECT_CALL(mock_utils, trigger_copyup(_, object_no, _, _))
+      .WillOnce(WithArg<3>(Invoke([r](Context* ctx) {
+                             if (r) {
+                               ctx->complete(0);
+                             }
+                             return r;
+                           })));
+  }
+
   void expect_copyup(MockCopyupRequest& mock_copyup_request, int r) {
     EXPECT_CALL(mock_copyup_request, send())
       .WillOnce(Invoke([]() {}));
@@ -706,6 +726,131 @@ TEST_F(TestMockIoObjectRequest, CopyOnRead) {
   ASSERT_EQ(0, ctx.wait());
 }
 
+TEST_F(TestMockIoObjectRequest, CopyOnReadPrefetch) {
+  REQUIRE_FEATURE(RBD_FEATURE_LAYERING | RBD_FEATURE_OBJECT_MAP);
+
+  librbd::Image image;
+  librbd::RBD rbd;
+  ASSERT_EQ(0, rbd.open(m_ioctx, image, m_image_name.c_str(), NULL));
+  ASSERT_EQ(0, image.snap_create("one"));
+  ASSERT_EQ(0, image.snap_protect("one"));
+  image.close();
+
+  std::string clone_name = get_temp_image_name();
+  int order = 0;
+  ASSERT_EQ(0, rbd.clone(m_ioctx, m_image_name.c_str(), "one", m_ioctx,
+                         clone_name.c_str(), RBD_FEATURE_LAYERING, &order));
+
+  librbd::ImageCtx *ictx;
+  ASSERT_EQ(0, open_image(clone_name, &ictx));
+  ictx->sparse_read_threshold_bytes = 8096;
+  ictx->clone_copy_on_read = true;
+  ictx->clone_copy_on_read_prefetch_objects = 3;
+
+  MockTestImageCtx mock_image_ctx(*ictx);
+  mock_image_ctx.parent = &mock_image_ctx;
+
+  MockObjectMap mock_object_map;
+  mock_image_ctx.object_map = &mock_object_map;
+
+  InSequence seq;
+  expect_object_may_exist(mock_image_ctx, 0, true);
+  expect_get_read_flags(mock_image_ctx, CEPH_NOSNAP, 0);
+  expect_read(mock_image_ctx, ictx->get_object_name(0), 0, 4096, "", -ENOENT);
+
+  MockUtils mock_utils;
+  ReadExtents extents = {{0, 4096}};
+  expect_read_parent(mock_utils, 0, &extents, CEPH_NOSNAP, 0);
+
+  MockCopyupRequest mock_copyup_request;
+  expect_get_parent_overlap(mock_image_ctx, CEPH_NOSNAP, 4096, 0);
+  expect_prune_parent_extents(mock_image_ctx, {{0, 4096}}, 4096, 4096);
+  expect_copyup(mock_copyup_request, 0);
+
+  EXPECT_CALL(mock_object_map, size()).WillOnce(Return(4));
+  expect_object_may_exist(mock_image_ctx, 1, false);
+  expect_object_may_exist(mock_image_ctx, 2, true);
+  expect_object_may_exist(mock_image_ctx, 3, false);
+  expect_trigger_copyup(mock_utils, 1, true);
+  expect_trigger_copyup(mock_utils, 3, false);
+
+  C_SaferCond ctx;
+  auto req = MockObjectReadRequest::create(
+    &mock_image_ctx, 0, &extents,
+    mock_image_ctx.get_data_io_context(), 0, 0, {},
+    nullptr, &ctx);
+  req->send();
+  ASSERT_EQ(0, ctx.wait());
+  ASSERT_EQ(0U, mock_image_ctx.copyup_prefetch_in_flight);
+}
+
+TEST_F(TestMockIoObjectRequest, CopyOnReadPrefetchBounded) {
+  REQUIRE_FEATURE(RBD_FEATURE_LAYERING | RBD_FEATURE_OBJECT_MAP);
+
+  librbd::Image image;
+  librbd::RBD rbd;
+  ASSERT_EQ(0, rbd.open(m_ioctx, image, m_image_name.c_str(), NULL));
+  ASSERT_EQ(0, image.snap_create("one"));
+  ASSERT_EQ(0, image.snap_protect("one"));
+  image.close();
+
+  std::string clone_name = get_temp_image_name();
+  int order = 0;
+  ASSERT_EQ(0, rbd.clone(m_ioctx, m_image_name.c_str(), "one", m_ioctx,
+                         clone_name.c_str(), RBD_FEATURE_LAYERING, &order));
+
+  librbd::ImageCtx *ictx;
+  ASSERT_EQ(0, open_image(clone_name, &ictx));
+  ictx->sparse_read_threshold_bytes = 8096;
+  ictx->clone_copy_on_read = true;
+  ictx->clone_copy_on_read_prefetch_objects = 2;
+
+  MockTestImageCtx mock_image_ctx(*ictx);
+  mock_image_ctx.parent = &mock_image_ctx;
+  // another reader's prefetch is still outstanding
+  mock_image_ctx.copyup_prefetch_in_flight = 1;
+
+  MockObjectMap mock_object_map;
+  mock_image_ctx.object_map = &mock_object_map;
+
+  InSequence seq;
+  expect_object_may_exist(mock_image_ctx, 0, true);
+  expect_get_read_flags(mock_image_ctx, CEPH_NOSNAP, 0);
+  expect_read(mock_image_ctx, ictx->get_object_name(0), 0, 4096, "", -ENOENT);
+
+  MockUtils mock_utils;
+  ReadExtents extents = {{0, 4096}};
+  expect_read_parent(mock_utils, 0, &extents, CEPH_NOSNAP, 0);
+
+  MockCopyupRequest mock_copyup_request;
+  expect_get_parent_overlap(mock_image_ctx, CEPH_NOSNAP, 4096, 0);
+  expect_prune_parent_extents(mock_image_ctx, {{0, 4096}}, 4096, 4096);
+  expect_copyup(mock_copyup_request, 0);
+
+  // only one prefetch fits into the budget: object 2 is not considered
+  EXPECT_CALL(mock_object_map, size()).WillOnce(Return(4));
+  expect_object_may_exist(mock_image_ctx, 1, false);
+  Context* prefetch_ctx = nullptr;
+  EXPECT_CALL(mock_utils, trigger_copyup(_, 1, _, _))
+    .WillOnce(WithArg<3>(Invoke([&prefetch_ctx](Context* ctx) {
+                           prefetch_ctx = ctx;
+                           return true;
+                         })));
+
+  C_SaferCond ctx;
+  auto req = MockObjectReadRequest::create(
+    &mock_image_ctx, 0, &extents,
+    mock_image_ctx.get_data_io_context(), 0, 0, {},
+    nullptr, &ctx);
+  req->send();
+  ASSERT_EQ(0, ctx.wait());
+  ASSERT_EQ(2U, mock_image_ctx.copyup_prefetch_in_flight);
+
+  ASSERT_TRUE(prefetch_ctx != nullptr);
+  prefetch_ctx->complete(0);
+  ASSERT_EQ(1U, mock_image_ctx.copyup_prefetch_in_flight);
+}
+
 TEST_F(TestMockIoObjectRequest, Write) {
   librbd::ImageCtx *ictx;
   ASSERT_EQ(0, open_image(m_image_name, &ictx));
@@ -4,85 +4,133 @@
 #include "test/librbd/test_mock_fixture.h"
 #include "test/librbd/test_support.h"
 #include "test/librbd/mock/MockImageCtx.h"
-#include "test/librbd/mock/exclusive_lock/MockPolicy.h"
-#include "librbd/io/ImageDispatchSpec.h"
-#include "librbd/io/ImageRequestWQ.h"
-#include "librbd/io/ImageRequest.h"
+#include "include/rbd/librbd.hpp"
+#include "librbd/io/QosImageDispatch.h"
 
 namespace librbd {
-namespace io {
+namespace {
 
-TEST_F(TestMockIoImageRequestWQ, QosNoLimit) {
-  librbd::ImageCtx *ictx;
-  ASSERT_EQ(0, open_image(m_image_name, &ictx));
+struct MockTestImageCtx : public MockImageCtx {
+  MockTestImageCtx(ImageCtx &image_ctx) : MockImageCtx(image_ctx) {
+  }
+};
 
-  MockTestImageCtx mock_image_ctx(*ictx);
+} // anonymous namespace
 
-  MockImageDispatchSpec mock_queued_image_request;
-  expect_was_throttled(mock_queued_image_request, false);
-  expect_set_throttled(mock_queued_image_request);
+namespace io {
 
-  InSequence seq;
-  MockImageRequestWQ mock_image_request_wq(&mock_image_ctx, "io", 60, nullptr);
+template <>
+struct FlushTracker<MockTestImageCtx> {
+  FlushTracker(MockTestImageCtx*) {
+  }
 
-  mock_image_request_wq.apply_qos_limit(IMAGE_DISPATCH_FLAG_QOS_BPS_THROTTLE, 0,
-                                        0, 1);
+  void shut_down() {
+  }
 
-  expect_front(mock_image_request_wq, &mock_queued_image_request);
-  expect_is_refresh_request(mock_image_ctx, false);
-  expect_is_write_op(mock_queued_image_request, true);
-  expect_dequeue(mock_image_request_wq, &mock_queued_image_request);
-  ASSERT_TRUE(mock_image_request_wq.invoke_dequeue() == &mock_queued_image_request);
-}
+  void flush(Context*) {
+  }
 
-TEST_F(TestMockIoImageRequestWQ, BPSQosNoBurst) {
-  librbd::ImageCtx *ictx;
-  ASSERT_EQ(0, open_image(m_image_name, &ictx));
+  void start_io(uint64_t) {
+  }
 
-  MockTestImageCtx mock_image_ctx(*ictx);
+  void finish_io(uint64_t) {
+  }
 
-  MockImageDispatchSpec mock_queued_image_request;
-  expect_was_throttled(mock_queued_image_request, false);
-  expect_set_throttled(mock_queued_image_request);
+};
 
-  InSequence seq;
-  MockImageRequestWQ mock_image_request_wq(&mock_image_ctx, "io", 60, nullptr);
+} // namespace io
+} // namespace librbd
 
-  mock_image_request_wq.apply_qos_limit(IMAGE_DISPATCH_FLAG_QOS_BPS_THROTTLE, 1,
-                                        0, 1);
+#include "librbd/io/QosImageDispatch.cc"
 
-  expect_front(mock_image_request_wq, &mock_queued_image_request);
-  expect_tokens_requested(mock_queued_image_request, 2, true);
-  expect_dequeue(mock_image_request_wq, &mock_queued_image_request);
-  expect_all_throttled(mock_queued_image_request, true);
-  expect_requeue_back(mock_image_request_wq);
-  expect_signal(mock_image_request_wq);
-  ASSERT_TRUE(mock_image_request_wq.invoke_dequeue() == nullptr);
-}
+namespace librbd {
+namespace io {
 
-TEST_F(TestMockIoImageRequestWQ, BPSQosWithBurst) {
+struct TestMockIoQosImageDispatch : public TestMockFixture {
+  typedef QosImageDispatch<librbd::MockTestImageCtx> MockQosImageDispatch;
+
+  bool read(MockQosImageDispatch& qos_image_dispatch, uint64_t tid,
+            uint64_t length, std::atomic<uint32_t>* image_dispatch_flags,
+            Context* on_dispatched) {
+    DispatchResult dispatch_result;
+    Context* on_finish = nullptr;
+    return qos_image_dispatch.read(
+      nullptr, {{0, length}}, ReadResult{}, {}, 0, 0, {}, tid,
+      image_dispatch_flags, &dispatch_result, &on_finish, on_dispatched);
+  }
+};
+
+TEST_F(TestMockIoQosImageDispatch, QosNoLimit) {
   librbd::ImageCtx *ictx;
   ASSERT_EQ(0, open_image(m_image_name, &ictx));
 
   MockTestImageCtx mock_image_ctx(*ictx);
+  MockQosImageDispatch mock_qos_image_dispatch(&mock_image_ctx);
+  mock_qos_image_dispatch.apply_qos_limit(IMAGE_DISPATCH_FLAG_QOS_BPS_THROTTLE,
+                                          0, 0, 1);
+
+  std::atomic<uint32_t> image_dispatch_flags{0};
+  C_SaferCond on_dispatched;
+  ASSERT_FALSE(read(mock_qos_image_dispatch, 1, 4096, &image_dispatch_flags,
+                    &on_dispatched));
+  ASSERT_EQ(IMAGE_DISPATCH_FLAG_QOS_MASK,
+            image_dispatch_flags & IMAGE_DISPATCH_FLAG_QOS_MASK);
+}
 
-  MockImageDispatchSpec mock_queued_image_request;
-  expect_was_throttled(mock_queued_image_request, false);
-  expect_set_throttled(mock_queued_image_request);
-
-  InSequence seq;
-  MockImageRequestWQ mock_image_request_wq(&mock_image_ctx, "io", 60, nullptr);
+TEST_F(TestMockIoQosImageDispatch, BPSQos) {
+  librbd::ImageCtx *ictx;
+  ASSERT_EQ(0, open_image(m_image_name, &ictx));
 
-  mock_image_request_wq.apply_qos_limit(IMAGE_DISPATCH_FLAG_QOS_BPS_THROTTLE, 1,
-                                        1, 1);
+  MockTestImageCtx mock_image_ctx(*ictx);
+  MockQosImageDispatch mock_qos_image_dispatch(&mock_image_ctx);
+  mock_qos_image_dispatch.apply_qos_limit(IMAGE_DISPATCH_FLAG_QOS_BPS_THROTTLE,
+                                          1000, 0, 1);
+
+  // the bucket starts out empty
+  std::atomic<uint32_t> image_dispatch_flags{0};
+  C_SaferCond on_dispatched;
+  ASSERT_TRUE(read(mock_qos_image_dispatch, 1, 2, &image_dispatch_flags,
+                   &on_dispatched));
+  ASSERT_EQ(0, on_dispatched.wait());
+  ASSERT_EQ(IMAGE_DISPATCH_FLAG_QOS_MASK,
+            image_dispatch_flags & IMAGE_DISPATCH_FLAG_QOS_MASK);
+}
 
-  expect_front(mock_image_request_wq, &mock_queued_image_request);
-  expect_tokens_requested(mock_queued_image_request, 2, true);
-  expect_dequeue(mock_image_request_wq, &mock_queued_image_request);
-  expect_all_throttled(mock_queued_image_request, true);
-  expect_requeue_back(mock_image_request_wq);
-  expect_signal(mock_image_request_wq);
-  ASSERT_TRUE(mock_image_request_wq.invoke_dequeue() == nullptr);
+TEST_F(TestMockIoQosImageDispatch, PoolThrottleShared) {
+  librbd::ImageCtx *ictx1;
+  ASSERT_EQ(0, open_image(m_image_name, &ictx1));
+
+  librbd::RBD rbd;
+  std::string image_name2 = get_temp_image_name();
+  ASSERT_EQ(0, create_image_pp(rbd, m_ioctx, image_name2, m_image_size));
+  librbd::ImageCtx *ictx2;
+  ASSERT_EQ(0, open_image(image_name2, &ictx2));
+
+  MockTestImageCtx mock_image_ctx1(*ictx1);
+  MockTestImageCtx mock_image_ctx2(*ictx2);
+  MockQosImageDispatch mock_qos_image_dispatch1(&mock_image_ctx1);
+  MockQosImageDispatch mock_qos_image_dispatch2(&mock_image_ctx2);
+
+  // both images apply the pool level limit: one op per second in total
+  mock_qos_image_dispatch1.apply_qos_limit(
+    IMAGE_DISPATCH_FLAG_QOS_POOL_IOPS_THROTTLE, 1, 0, 1);
+  mock_qos_image_dispatch2.apply_qos_limit(
+    IMAGE_DISPATCH_FLAG_QOS_POOL_IOPS_THROTTLE, 1, 0, 1);
+
+  std::atomic<uint32_t> image_dispatch_flags1{0};
+  std::atomic<uint32_t> image_dispatch_flags2{0};
+  C_SaferCond on_dispatched1;
+  C_SaferCond on_dispatched2;
+  ASSERT_TRUE(read(mock_qos_image_dispatch1, 1, 4096, &image_dispatch_flags1,
+                   &on_dispatched1));
+  ASSERT_TRUE(read(mock_qos_image_dispatch2, 2, 4096, &image_dispatch_flags2,
+                   &on_dispatched2));
+
+  // the second image queues behind the first within the same bucket and
+  // has to wait for the next token
+  ASSERT_EQ(0, on_dispatched1.wait());
+  ASSERT_EQ(ETIMEDOUT, on_dispatched2.wait_for(0.5));
+  ASSERT_EQ(0, on_dispatched2.wait());
 }
 
 } // namespace io
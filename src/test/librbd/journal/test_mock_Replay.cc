@@ -430,6 +430,68 @@ TEST_F(TestMockJournalReplay, AioWrite) {
   ASSERT_EQ(0, on_safe.wait());
 }
 
+TEST_F(TestMockJournalReplay, AioWriteConcurrent) {
+  REQUIRE_FEATURE(RBD_FEATURE_JOURNALING);
+
+  librbd::ImageCtx *ictx;
+  ASSERT_EQ(0, open_image(m_image_name, &ictx));
+
+  MockReplayImageCtx mock_image_ctx(*ictx);
+  mock_image_ctx.config.set_val("rbd_journal_replay_max_concurrent_ios", "2");
+
+  MockExclusiveLock mock_exclusive_lock;
+  mock_image_ctx.exclusive_lock = &mock_exclusive_lock;
+  expect_accept_ops(mock_exclusive_lock, true);
+
+  MockJournalReplay mock_journal_replay(mock_image_ctx);
+  MockIoImageRequest mock_io_image_request;
+  expect_op_work_queue(mock_image_ctx);
+
+  InSequence seq;
+  io::AioCompletion *aio_comp1 = nullptr;
+  io::AioCompletion *aio_comp2 = nullptr;
+  io::AioCompletion *aio_comp3 = nullptr;
+  C_SaferCond on_ready1;
+  C_SaferCond on_safe1;
+  C_SaferCond on_ready2;
+  C_SaferCond on_safe2;
+  C_SaferCond on_ready3;
+  C_SaferCond on_safe3;
+
+  // non-overlapping writes are ready before they are acked
+  expect_aio_write(mock_io_image_request, &aio_comp1, 0, 512, "test1");
+  when_process(mock_journal_replay,
+               EventEntry{AioWriteEvent(0, 512, to_bl("test1"))},
+               &on_ready1, &on_safe1);
+  ASSERT_EQ(0, on_ready1.wait());
+
+  expect_aio_write(mock_io_image_request, &aio_comp2, 1024, 512, "test2");
+  when_process(mock_journal_replay,
+               EventEntry{AioWriteEvent(1024, 512, to_bl("test2"))},
+               &on_ready2, &on_safe2);
+  ASSERT_EQ(0, on_ready2.wait());
+
+  // overlapping write is blocked until the first write is acked
+  expect_aio_write(mock_io_image_request, &aio_comp3, 256, 512, "test3");
+  when_process(mock_journal_replay,
+               EventEntry{AioWriteEvent(256, 512, to_bl("test3"))},
+               &on_ready3, &on_safe3);
+  ASSERT_EQ(nullptr, aio_comp3);
+
+  when_complete(mock_image_ctx, aio_comp1, 0);
+  ASSERT_EQ(0, on_ready3.wait());
+  ASSERT_NE(nullptr, aio_comp3);
+
+  when_complete(mock_image_ctx, aio_comp2, 0);
+  when_complete(mock_image_ctx, aio_comp3, 0);
+
+  expect_aio_flush(mock_image_ctx, mock_io_image_request, 0);
+  ASSERT_EQ(0, when_shut_down(mock_journal_replay, false));
+  ASSERT_EQ(0, on_safe1.wait());
+  ASSERT_EQ(0, on_safe2.wait());
+  ASSERT_EQ(0, on_safe3.wait());
+}
+
 TEST_F(TestMockJournalReplay, AioFlush) {
   REQUIRE_FEATURE(RBD_FEATURE_JOURNALING);
 
@@ -31,6 +31,8 @@ MockImageCtx::MockImageCtx(librbd::ImageCtx &image_ctx)
     read_only_flags(image_ctx.read_only_flags),
     read_only_mask(image_ctx.read_only_mask),
     clone_copy_on_read(image_ctx.clone_copy_on_read),
+    clone_copy_on_read_prefetch_objects(
+      image_ctx.clone_copy_on_read_prefetch_objects),
     lockers(image_ctx.lockers),
     exclusive_locked(image_ctx.exclusive_locked),
     lock_tag(image_ctx.lock_tag),
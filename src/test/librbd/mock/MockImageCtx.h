@@ -170,6 +170,7 @@ struct MockImageCtx {
   uint32_t read_only_mask;
 
   bool clone_copy_on_read;
+  uint64_t clone_copy_on_read_prefetch_objects;
 
   std::map<rados::cls::lock::locker_id_t,
            rados::cls::lock::locker_info_t> lockers;
@@ -212,6 +213,7 @@ struct MockImageCtx {
   std::list<Context*> async_requests_waiters;
 
   std::map<uint64_t, io::CopyupRequest<MockImageCtx>*> copyup_list;
+  uint64_t copyup_prefetch_in_flight = 0;
 
   io::MockImageDispatcher *io_image_dispatcher;
   io::MockObjectDispatcher *io_object_dispatcher;
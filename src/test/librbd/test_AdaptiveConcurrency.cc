@@ -0,0 +1,101 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+
+#include "librbd/AdaptiveConcurrency.h"
+#include "gtest/gtest.h"
+
+namespace librbd {
+
+using namespace std::chrono_literals;
+
+TEST(TestAdaptiveConcurrency, Disabled) {
+  AdaptiveConcurrency concurrency;
+  concurrency.reset(10, 0);
+  ASSERT_EQ(10U, concurrency.get());
+
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_FALSE(concurrency.update(i == 0 ? 1ms : 100ms));
+  }
+  ASSERT_EQ(10U, concurrency.get());
+}
+
+TEST(TestAdaptiveConcurrency, InitialClampedToLimit) {
+  AdaptiveConcurrency concurrency;
+  concurrency.reset(10, 4);
+  ASSERT_EQ(4U, concurrency.get());
+}
+
+TEST(TestAdaptiveConcurrency, GrowsToLimit) {
+  AdaptiveConcurrency concurrency;
+  concurrency.reset(2, 4);
+
+  // re-evaluated once per window of 'concurrency' completions
+  ASSERT_FALSE(concurrency.update(10ms));
+  ASSERT_TRUE(concurrency.update(10ms));
+  ASSERT_EQ(3U, concurrency.get());
+
+  ASSERT_FALSE(concurrency.update(10ms));
+  ASSERT_FALSE(concurrency.update(10ms));
+  ASSERT_TRUE(concurrency.update(10ms));
+  ASSERT_EQ(4U, concurrency.get());
+
+  for (int i = 0; i < 16; ++i) {
+    ASSERT_FALSE(concurrency.update(10ms));
+  }
+  ASSERT_EQ(4U, concurrency.get());
+}
+
+TEST(TestAdaptiveConcurrency, BacksOffWhenQueueing) {
+  AdaptiveConcurrency concurrency;
+  concurrency.reset(16, 16);
+
+  concurrency.update(1ms);
+  for (int i = 0; i < 15; ++i) {
+    concurrency.update(100ms);
+  }
+  ASSERT_EQ(12U, concurrency.get());
+  // the minimum drifts up by 5% per window
+  ASSERT_EQ(ceph::timespan(1050us), concurrency.get_min_latency());
+  ASSERT_GT(concurrency.get_avg_latency(), concurrency.get_min_latency() * 2);
+
+  // never drops below a single op
+  for (int i = 0; i < 40; ++i) {
+    concurrency.update(100ms);
+  }
+  ASSERT_EQ(1U, concurrency.get());
+}
+
+TEST(TestAdaptiveConcurrency, IgnoresZeroLatency) {
+  AdaptiveConcurrency concurrency;
+  concurrency.reset(2, 4);
+
+  for (int i = 0; i < 16; ++i) {
+    ASSERT_FALSE(concurrency.update(ceph::timespan::zero()));
+  }
+  ASSERT_EQ(2U, concurrency.get());
+  ASSERT_EQ(ceph::timespan::zero(), concurrency.get_min_latency());
+
+  ASSERT_FALSE(concurrency.update(10ms));
+  ASSERT_TRUE(concurrency.update(10ms));
+  ASSERT_EQ(3U, concurrency.get());
+}
+
+TEST(TestAdaptiveConcurrency, RecoversFromLowMinLatency) {
+  AdaptiveConcurrency concurrency;
+  concurrency.reset(4, 4);
+
+  // a single fast op followed by a steady, higher latency
+  concurrency.update(1ms);
+  for (int i = 0; i < 32; ++i) {
+    concurrency.update(10ms);
+  }
+  ASSERT_EQ(1U, concurrency.get());
+
+  for (int i = 0; i < 200; ++i) {
+    concurrency.update(10ms);
+  }
+  ASSERT_EQ(4U, concurrency.get());
+  ASSERT_GT(concurrency.get_min_latency(), ceph::timespan(5ms));
+}
+
+} // namespace librbd
@@ -8,6 +8,7 @@
 #include "test/librbd/test_fixture.h"
 #include "test/librbd/test_support.h"
 #include "include/rbd/librbd.h"
+#include "librbd/AsioEngine.h"
 #include "librbd/ExclusiveLock.h"
 #include "librbd/ImageState.h"
 #include "librbd/ImageWatcher.h"
@@ -27,6 +28,8 @@
 #include <boost/scope_exit.hpp>
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/assign/list_of.hpp>
+#include <future>
+#include <thread>
 #include <utility>
 #include <vector>
 #include "test/librados/crimson_utils.h"
@@ -1865,4 +1868,143 @@ TEST_F(TestInternal, MissingDataPool) {
   ASSERT_EQ(0, create_image_pp(m_rbd, m_ioctx, m_image_name, m_image_size));
 }
 
+namespace {
+
+struct ExternalCallbacks {
+  std::mutex lock;
+  std::vector<int> order;
+  std::atomic<int> running{0};
+  std::atomic<bool> overlapped{false};
+};
+
+struct ExternalCallbackArg {
+  ExternalCallbacks* callbacks;
+  int id;
+};
+
+void external_callback(librbd::completion_t cb, void *arg) {
+  auto callback_arg = reinterpret_cast<ExternalCallbackArg*>(arg);
+  auto callbacks = callback_arg->callbacks;
+  if (++callbacks->running > 1) {
+    callbacks->overlapped = true;
+  }
+  {
+    std::lock_guard locker{callbacks->lock};
+    callbacks->order.push_back(callback_arg->id);
+  }
+  std::this_thread::yield();
+  --callbacks->running;
+}
+
+io::AioCompletion* create_external_aio_comp(ImageCtx* ictx,
+                                            ExternalCallbackArg* arg) {
+  auto aio_comp = io::AioCompletion::create(arg, external_callback, nullptr);
+  aio_comp->external_callback = true;
+  aio_comp->init_time(ictx, io::AIO_TYPE_GENERIC);
+  aio_comp->start_op();
+  aio_comp->set_request_count(1);
+  return aio_comp;
+}
+
+} // anonymous namespace
+
+TEST_F(TestInternal, AioCompletionExternalCallbackOrder) {
+  librbd::ImageCtx *ictx;
+  ASSERT_EQ(0, open_image(m_image_name, &ictx));
+
+  // hold the api strand so that all completions below are batched
+  std::promise<void> strand_blocked;
+  std::promise<void> strand_release;
+  auto strand_release_future = strand_release.get_future();
+  boost::asio::post(ictx->asio_engine->get_api_strand(),
+                    [&strand_blocked, &strand_release_future]() {
+      strand_blocked.set_value();
+      strand_release_future.wait();
+    });
+  strand_blocked.get_future().wait();
+
+  const int count = 16;
+  ExternalCallbacks callbacks;
+  std::vector<ExternalCallbackArg> args(count);
+  std::vector<io::AioCompletion*> aio_comps;
+  for (int i = 0; i < count; ++i) {
+    args[i] = {&callbacks, i};
+    aio_comps.push_back(create_external_aio_comp(ictx, &args[i]));
+  }
+  for (auto aio_comp : aio_comps) {
+    aio_comp->complete_request(0);
+    ASSERT_TRUE(aio_comp->is_complete());
+  }
+  strand_release.set_value();
+
+  std::vector<int> expected_order;
+  for (int i = 0; i < count; ++i) {
+    ASSERT_EQ(0, aio_comps[i]->wait_for_complete());
+    expected_order.push_back(i);
+  }
+  ASSERT_EQ(expected_order, callbacks.order);
+  ASSERT_FALSE(callbacks.overlapped);
+
+  for (auto aio_comp : aio_comps) {
+    aio_comp->release();
+  }
+}
+
+TEST_F(TestInternal, AioCompletionExternalCallbackConcurrency) {
+  librbd::ImageCtx *ictx;
+  ASSERT_EQ(0, open_image(m_image_name, &ictx));
+
+  const int thread_count = 8;
+  const int count = 64;
+  ExternalCallbacks callbacks;
+  std::vector<ExternalCallbackArg> args(thread_count * count);
+  std::vector<io::AioCompletion*> aio_comps;
+  for (int i = 0; i < thread_count * count; ++i) {
+    args[i] = {&callbacks, i};
+    aio_comps.push_back(create_external_aio_comp(ictx, &args[i]));
+  }
+
+  // waiters that block before their completion fires
+  std::vector<std::thread> waiters;
+  for (int i = 0; i < thread_count; ++i) {
+    auto aio_comp = aio_comps[(i + 1) * count - 1];
+    waiters.emplace_back([aio_comp]() { aio_comp->wait_for_complete(); });
+  }
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < thread_count; ++i) {
+    threads.emplace_back([&aio_comps, i]() {
+        for (int j = 0; j < count; ++j) {
+          aio_comps[i * count + j]->complete_request(0);
+        }
+      });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto& waiter : waiters) {
+    waiter.join();
+  }
+
+  for (auto aio_comp : aio_comps) {
+    ASSERT_EQ(0, aio_comp->wait_for_complete());
+  }
+  ASSERT_FALSE(callbacks.overlapped);
+  ASSERT_EQ(static_cast<size_t>(thread_count * count), callbacks.order.size());
+
+  // every thread's completions are delivered in the order it completed them
+  std::vector<int> last_ids(thread_count, -1);
+  for (auto id : callbacks.order) {
+    ASSERT_LT(last_ids[id / count], id);
+    last_ids[id / count] = id;
+  }
+
+  // a waiter arriving after the completion must not block
+  ASSERT_EQ(0, aio_comps[0]->wait_for_complete());
+
+  for (auto aio_comp : aio_comps) {
+    aio_comp->release();
+  }
+}
+
 } // namespace librbd
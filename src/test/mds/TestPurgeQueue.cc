@@ -0,0 +1,98 @@
+// -*- mode:C++; tab-width:8; c-basic-offset:2; indent-tabs-mode:t -*-
+// vim: ts=8 sw=2 smarttab
+/*
+ * Ceph - scalable distributed file system
+ *
+ * This is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License version 2.1, as published by the Free Software
+ * Foundation.  See file COPYING.
+ *
+ */
+
+#include <boost/asio/io_context.hpp>
+
+#include "global/global_context.h"
+#include "include/Context.h"
+#include "mds/MDSMap.h"
+#include "mds/PurgeQueue.h"
+#include "osdc/Objecter.h"
+
+#include "gtest/gtest.h"
+
+TEST(PurgeQueue, OpLimitBeforeCreateLogger)
+{
+  boost::asio::io_context ioc;
+  Objecter objecter(g_ceph_context, nullptr, nullptr, ioc);
+  MDSMap mdsmap;
+
+  PurgeQueue pq(g_ceph_context, 0, 1, &objecter,
+                new LambdaContext([](int r) {}));
+  // same order as a fresh MDSRank: the op limit is computed in its
+  // constructor, the perf counters only in MDSRankDispatcher::init()
+  pq.update_op_limit(mdsmap);
+  pq.create_logger();
+  pq.update_op_limit(mdsmap);
+}
+
+static void run_window(PurgeOpLimiter& limiter, double latency,
+                       uint64_t ceiling)
+{
+  for (unsigned i = 0; i < PurgeOpLimiter::WINDOW; ++i) {
+    limiter.update(latency, ceiling);
+  }
+}
+
+TEST(PurgeOpLimiter, StartsAtCeiling)
+{
+  PurgeOpLimiter limiter;
+  ASSERT_EQ(100u, limiter.get(100));
+
+  run_window(limiter, 0.001, 100);
+  ASSERT_EQ(100u, limiter.get(100));
+  // the ceiling follows the PG count and may drop underneath us
+  ASSERT_EQ(50u, limiter.get(50));
+}
+
+TEST(PurgeOpLimiter, BacksOffAndRecovers)
+{
+  PurgeOpLimiter limiter;
+  run_window(limiter, 0.001, 100);
+
+  run_window(limiter, 0.01, 100);
+  ASSERT_EQ(75u, limiter.get(100));
+  run_window(limiter, 0.01, 100);
+  ASSERT_EQ(56u, limiter.get(100));
+
+  // latency back to normal: regrow by 1/8 of the limit per window
+  for (unsigned i = 0; i < 100 && limiter.get(100) < 100; ++i) {
+    run_window(limiter, 0.001, 100);
+  }
+  ASSERT_EQ(100u, limiter.get(100));
+}
+
+TEST(PurgeOpLimiter, SlowerClusterNotCongestedForever)
+{
+  PurgeOpLimiter limiter;
+  run_window(limiter, 0.001, 100);
+
+  // the cluster got 10x slower and stays that way
+  unsigned windows = 0;
+  for (; windows < 500 && limiter.get(100) < 100; ++windows) {
+    run_window(limiter, 0.01, 100);
+  }
+  ASSERT_LT(windows, 500u);
+  ASSERT_EQ(100u, limiter.get(100));
+}
+
+TEST(PurgeOpLimiter, Reset)
+{
+  PurgeOpLimiter limiter;
+  run_window(limiter, 0.001, 100);
+  run_window(limiter, 0.01, 100);
+  ASSERT_EQ(75u, limiter.get(100));
+
+  limiter.reset();
+  ASSERT_EQ(100u, limiter.get(100));
+  ASSERT_EQ(0, limiter.get_avg_latency());
+}
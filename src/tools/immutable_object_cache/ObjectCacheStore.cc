@@ -3,6 +3,8 @@
 
 #include "ObjectCacheStore.h"
 #include "Utils.h"
+#include "common/ceph_crypto.h"
+#include "common/errno.h"
 #include <filesystem>
 
 #define dout_context g_ceph_context
@@ -59,6 +61,12 @@ ObjectCacheStore::ObjectCacheStore(CephContext *cct)
   uint64_t max_inflight_ops =
     m_cct->_conf.get_val<uint64_t>("immutable_object_cache_max_inflight_ops");
 
+  uint64_t promote_min_misses =
+    m_cct->_conf.get_val<uint64_t>("immutable_object_cache_promote_min_misses");
+
+  m_dedup_enabled =
+    m_cct->_conf.get_val<bool>("immutable_object_cache_dedup");
+
   uint64_t limit = 0;
   if ((limit = m_cct->_conf.get_val<uint64_t>
                    ("immutable_object_cache_qos_iops_limit")) != 0) {
@@ -88,7 +96,7 @@ ObjectCacheStore::ObjectCacheStore(CephContext *cct)
     cache_watermark = 0.9;
   }
   m_policy = new SimplePolicy(m_cct, cache_max_size, max_inflight_ops,
-                              cache_watermark);
+                              cache_watermark, promote_min_misses);
 }
 
 ObjectCacheStore::~ObjectCacheStore() {
@@ -208,15 +216,7 @@ int ObjectCacheStore::handle_promote_callback(int ret, bufferlist* read_buf,
     state = OBJ_CACHE_DNE;
     ret = 0;
   } else {
-    std::string cache_file_path = get_cache_file_path(cache_file_name, true);
-    if (cache_file_path == "") {
-      lderr(m_cct) << "fail to write cache file" << dendl;
-      m_policy->update_status(cache_file_name, OBJ_CACHE_NONE);
-      delete read_buf;
-      return -ENOSPC;
-    }
-
-    ret = read_buf->write_file(cache_file_path.c_str());
+    ret = write_cache_file(cache_file_name, *read_buf);
     if (ret < 0) {
       lderr(m_cct) << "fail to write cache file" << dendl;
 
@@ -265,7 +265,8 @@ int ObjectCacheStore::lookup_object(std::string pool_nspace, uint64_t pool_id,
       return ret;
     }
     case OBJ_CACHE_PROMOTED:
-      target_cache_file_path = get_cache_file_path(cache_file_name);
+      target_cache_file_path = get_cache_file_path(
+        get_data_file_name(cache_file_name));
       return ret;
     case OBJ_CACHE_DNE:
       if (return_dne_path) {
@@ -315,12 +316,18 @@ int ObjectCacheStore::do_evict(std::string cache_file) {
     return 0;
   }
 
-  std::string cache_file_path = get_cache_file_path(cache_file);
+  int ret = -ENOENT;
+  if (m_dedup_enabled) {
+    ret = evict_content_file(cache_file);
+  }
+  if (ret == -ENOENT) {
+    std::string cache_file_path = get_cache_file_path(cache_file);
 
-  ldout(m_cct, 20) << "evict cache: " << cache_file_path << dendl;
+    ldout(m_cct, 20) << "evict cache: " << cache_file_path << dendl;
 
-  // TODO(dehao): possible race on read?
-  int ret = std::remove(cache_file_path.c_str());
+    // TODO(dehao): possible race on read?
+    ret = std::remove(cache_file_path.c_str());
+  }
   // evict metadata
   if (ret == 0) {
     m_policy->update_status(cache_file, OBJ_CACHE_SKIP);
@@ -330,6 +337,37 @@ int ObjectCacheStore::do_evict(std::string cache_file) {
   return ret;
 }
 
+int ObjectCacheStore::evict_content_file(const std::string& cache_file) {
+  // the content file is removed under the lock so that a concurrent
+  // promotion of identical data cannot publish it in between
+  std::lock_guard locker{m_content_lock};
+  auto it = m_content_file_names.find(cache_file);
+  if (it == m_content_file_names.end()) {
+    return -ENOENT;
+  }
+
+  const std::string& data_file = it->second;
+  auto ref_it = m_content_file_refs.find(data_file);
+  ceph_assert(ref_it != m_content_file_refs.end() && ref_it->second > 0);
+  if (ref_it->second == 1) {
+    std::string cache_file_path = get_cache_file_path(data_file);
+    ldout(m_cct, 20) << "evict cache: " << cache_file_path << dendl;
+    if (std::remove(cache_file_path.c_str()) != 0 && errno != ENOENT) {
+      int r = -errno;
+      lderr(m_cct) << "failed to remove " << cache_file_path << ": "
+                   << cpp_strerror(r) << dendl;
+      return r;
+    }
+    m_content_file_refs.erase(ref_it);
+  } else {
+    ldout(m_cct, 20) << "evict cache: " << cache_file << " (" << data_file
+                     << " still referenced)" << dendl;
+    --ref_it->second;
+  }
+  m_content_file_names.erase(it);
+  return 0;
+}
+
 std::string ObjectCacheStore::get_cache_file_name(std::string pool_nspace,
                                                        uint64_t pool_id,
                                                        uint64_t snap_id,
@@ -338,6 +376,97 @@ std::string ObjectCacheStore::get_cache_file_name(std::string pool_nspace,
          std::to_string(snap_id) + ":" + oid;
 }
 
+std::string ObjectCacheStore::get_data_file_name(
+    const std::string& cache_file_name) {
+  if (!m_dedup_enabled) {
+    return cache_file_name;
+  }
+
+  std::lock_guard locker{m_content_lock};
+  auto it = m_content_file_names.find(cache_file_name);
+  if (it == m_content_file_names.end()) {
+    return cache_file_name;
+  }
+  return it->second;
+}
+
+std::string ObjectCacheStore::get_content_file_name(const bufferlist& data) {
+  ceph::crypto::SHA256 sha256;
+  for (auto& p : data.buffers()) {
+    sha256.Update(reinterpret_cast<const unsigned char*>(p.c_str()),
+                  p.length());
+  }
+
+  sha256_digest_t digest;
+  sha256.Final(digest.v);
+  return "sha256:" + digest.to_str();
+}
+
+int ObjectCacheStore::write_cache_file(const std::string& cache_file_name,
+                                       bufferlist& data) {
+  if (!m_dedup_enabled) {
+    std::string cache_file_path = get_cache_file_path(cache_file_name, true);
+    if (cache_file_path == "") {
+      return -ENOSPC;
+    }
+    return data.write_file(cache_file_path.c_str());
+  }
+
+  std::string content_file_name = get_content_file_name(data);
+  {
+    std::lock_guard locker{m_content_lock};
+    if (get_content_file_ref(cache_file_name, content_file_name)) {
+      return 0;
+    }
+  }
+
+  // write to a private file without holding the lock, the content file
+  // only becomes visible once it is complete
+  std::string content_file_path = get_cache_file_path(content_file_name, true);
+  if (content_file_path == "") {
+    return -ENOSPC;
+  }
+  std::string tmp_file_path = content_file_path + ".tmp." +
+                              std::to_string(++m_tmp_file_seq);
+  int r = data.write_file(tmp_file_path.c_str());
+  if (r < 0) {
+    std::remove(tmp_file_path.c_str());
+    return r;
+  }
+
+  std::lock_guard locker{m_content_lock};
+  if (get_content_file_ref(cache_file_name, content_file_name)) {
+    // a promotion of identical data won the race
+    std::remove(tmp_file_path.c_str());
+    return 0;
+  }
+  if (::rename(tmp_file_path.c_str(), content_file_path.c_str()) != 0) {
+    r = -errno;
+    lderr(m_cct) << "failed to rename " << tmp_file_path << ": "
+                 << cpp_strerror(r) << dendl;
+    std::remove(tmp_file_path.c_str());
+    return r;
+  }
+  m_content_file_refs[content_file_name] = 1;
+  m_content_file_names[cache_file_name] = content_file_name;
+  return 0;
+}
+
+bool ObjectCacheStore::get_content_file_ref(
+    const std::string& cache_file_name, const std::string& content_file_name) {
+  ceph_assert(ceph_mutex_is_locked_by_me(m_content_lock));
+  auto ref_it = m_content_file_refs.find(content_file_name);
+  if (ref_it == m_content_file_refs.end()) {
+    return false;
+  }
+
+  ldout(m_cct, 20) << cache_file_name << " shares content with existing "
+                   << "cache file " << content_file_name << dendl;
+  ++ref_it->second;
+  m_content_file_names[cache_file_name] = content_file_name;
+  return true;
+}
+
 std::string ObjectCacheStore::get_cache_file_path(std::string cache_file_name,
                                                   bool mkdir) {
   ldout(m_cct, 20) << cache_file_name <<dendl;
@@ -17,6 +17,7 @@
 using librados::Rados;
 using librados::IoCtx;
 class Context;
+class TestObjectStore;
 
 namespace ceph {
 namespace immutable_obj_cache {
@@ -38,6 +39,8 @@ class ObjectCacheStore {
                     bool return_dne_path,
                     std::string& target_cache_file_path);
  private:
+  friend class ::TestObjectStore;
+
   enum ThrottleTypeCode {
     THROTTLE_CODE_BYTE,
     THROTTLE_CODE_OBJECT
@@ -47,6 +50,9 @@ class ObjectCacheStore {
                                   uint64_t snap_id, std::string oid);
   std::string get_cache_file_path(std::string cache_file_name,
                                   bool mkdir = false);
+  std::string get_data_file_name(const std::string& cache_file_name);
+  std::string get_content_file_name(const bufferlist& data);
+  int write_cache_file(const std::string& cache_file_name, bufferlist& data);
   int evict_objects();
   int do_promote(std::string pool_nspace, uint64_t pool_id,
                  uint64_t snap_id, std::string object_name);
@@ -55,6 +61,9 @@ class ObjectCacheStore {
                      Context* on_finish);
   int handle_promote_callback(int, bufferlist*, std::string);
   int do_evict(std::string cache_file);
+  int evict_content_file(const std::string& cache_file);
+  bool get_content_file_ref(const std::string& cache_file_name,
+                            const std::string& content_file_name);
 
   bool take_token_from_throttle(uint64_t object_size, uint64_t object_num);
   void handle_throttle_ready(uint64_t tokens, uint64_t type);
@@ -70,6 +79,13 @@ class ObjectCacheStore {
     ceph::make_mutex("ceph::cache::ObjectCacheStore::m_ioctx_map_lock");
   Policy* m_policy;
   std::string m_cache_root_dir;
+  // content-addressed storage of identical objects
+  bool m_dedup_enabled{false};
+  std::map<std::string, std::string> m_content_file_names;
+  std::map<std::string, uint64_t> m_content_file_refs;
+  ceph::mutex m_content_lock =
+    ceph::make_mutex("ceph::cache::ObjectCacheStore::m_content_lock");
+  std::atomic<uint64_t> m_tmp_file_seq{0};
   // throttle mechanism
   uint64_t m_qos_enabled_flag{0};
   std::map<uint64_t, TokenBucketThrottle*> m_throttles;
@@ -13,14 +13,20 @@
 namespace ceph {
 namespace immutable_obj_cache {
 
+// upper bound on the number of not yet admitted objects whose misses are
+// tracked -- the history is forgotten once it grows past this
+static const uint64_t MAX_MISS_COUNT_ENTRIES = 1 << 16;
+
 SimplePolicy::SimplePolicy(CephContext *cct, uint64_t cache_size,
-                           uint64_t max_inflight, double watermark)
+                           uint64_t max_inflight, double watermark,
+                           uint64_t promote_min_misses)
   : cct(cct), m_watermark(watermark), m_max_inflight_ops(max_inflight),
-    m_max_cache_size(cache_size) {
+    m_max_cache_size(cache_size), m_promote_min_misses(promote_min_misses) {
 
   ldout(cct, 20) << "max cache size= " << m_max_cache_size
                  << " ,watermark= " << m_watermark
-                 << " ,max inflight ops= " << m_max_inflight_ops << dendl;
+                 << " ,max inflight ops= " << m_max_inflight_ops
+                 << " ,promote min misses= " << m_promote_min_misses << dendl;
 
   m_cache_size = 0;
 
@@ -46,8 +52,25 @@ cache_status_t SimplePolicy::alloc_entry(std::string file_name) {
     return OBJ_CACHE_SKIP;
   }
 
+  // only admit objects which have been missed often enough
+  if (m_promote_min_misses > 1) {
+    auto count_it = m_miss_counts.find(file_name);
+    if (count_it == m_miss_counts.end()) {
+      if (m_miss_counts.size() >= MAX_MISS_COUNT_ENTRIES) {
+        m_miss_counts.clear();
+      }
+      count_it = m_miss_counts.emplace(file_name, 0).first;
+    }
+    if (++count_it->second < m_promote_min_misses) {
+      ldout(cct, 20) << "not admitted yet: " << file_name << ", misses="
+                     << count_it->second << dendl;
+      return OBJ_CACHE_SKIP;
+    }
+  }
+
   if ((m_cache_size < m_max_cache_size) &&
       (inflight_ops < m_max_inflight_ops)) {
+    m_miss_counts.erase(file_name);
     Entry* entry = new Entry();
     ceph_assert(entry != nullptr);
     m_cache_map[file_name] = entry;
@@ -18,7 +18,7 @@ namespace immutable_obj_cache {
 class SimplePolicy : public Policy {
  public:
   SimplePolicy(CephContext *cct, uint64_t block_num, uint64_t max_inflight,
-               double watermark);
+               double watermark, uint64_t promote_min_misses = 1);
   ~SimplePolicy();
 
   cache_status_t lookup_object(std::string file_name);
@@ -53,8 +53,11 @@ class SimplePolicy : public Policy {
   uint64_t m_max_inflight_ops;
   uint64_t m_max_cache_size;
   std::atomic<uint64_t> inflight_ops = 0;
+  uint64_t m_promote_min_misses;
 
   std::unordered_map<std::string, Entry*> m_cache_map;
+  // misses of objects not yet admitted into the cache
+  std::unordered_map<std::string, uint64_t> m_miss_counts;
   ceph::shared_mutex m_cache_map_lock =
     ceph::make_shared_mutex("rbd::cache::SimplePolicy::m_cache_map_lock");
 
@@ -9,6 +9,7 @@
 #include "common/errno.h"
 #include "common/Throttle.h"
 #include "include/encoding.h"
+#include "include/interval_set.h"
 #include <iostream>
 #include <fcntl.h>
 #include <stdlib.h>
@@ -319,15 +320,23 @@ class C_Export : public Context
 {
 public:
   C_Export(OrderedThrottle &ordered_throttle, librbd::Image &image,
-	   uint64_t fd_offset, uint64_t offset, uint64_t length, int fd)
+	   uint64_t fd_offset, uint64_t offset, uint64_t length, int fd,
+	   bool exists = true)
     : m_throttle(ordered_throttle), m_image(image), m_dest_offset(fd_offset),
-      m_offset(offset), m_length(length), m_fd(fd)
+      m_offset(offset), m_length(length), m_fd(fd), m_exists(exists)
   {
   }
 
   void send()
   {
     auto ctx = m_throttle.start_op(this);
+    if (!m_exists) {
+      // unallocated extent: no need to read it from the cluster
+      m_bufferlist.append_zero(m_length);
+      ctx->complete(m_length);
+      return;
+    }
+
     auto aio_completion = new librbd::RBD::AioCompletion(
       ctx, &utils::aio_context_callback);
     int op_flags = LIBRADOS_OP_FLAG_FADVISE_SEQUENTIAL |
@@ -384,8 +393,43 @@ private:
   uint64_t m_offset;
   uint64_t m_length;
   int m_fd;
+  bool m_exists;
 };
 
+static int export_allocated_cb(uint64_t offset, size_t length, int exists,
+                               void *arg) {
+  auto allocated_extents = reinterpret_cast<interval_set<uint64_t> *>(arg);
+  if (exists) {
+    allocated_extents->union_insert(offset, length);
+  }
+  return 0;
+}
+
+static int get_allocated_extents(librbd::Image& image, uint64_t size,
+                                 interval_set<uint64_t> *allocated_extents) {
+  uint64_t features;
+  int r = image.features(&features);
+  if (r < 0) {
+    return r;
+  }
+
+  uint64_t flags;
+  r = image.get_flags(&flags);
+  if (r < 0) {
+    return r;
+  }
+
+  // only worthwhile when the object map can answer without touching
+  // every data object
+  if ((features & RBD_FEATURE_FAST_DIFF) == 0 ||
+      (flags & RBD_FLAG_FAST_DIFF_INVALID) != 0) {
+    return -EOPNOTSUPP;
+  }
+
+  return image.diff_iterate2(nullptr, 0, size, true, true,
+                             &export_allocated_cb, allocated_extents);
+}
+
 const uint32_t MAX_KEYS = 64;
 
 static int do_export_v2(librbd::Image& image, librbd::image_info_t &info, int fd,
@@ -523,6 +567,11 @@ static int do_export_v1(librbd::Image& image, librbd::image_info_t &info,
 {
   int r = 0;
   size_t file_size = 0;
+
+  interval_set<uint64_t> allocated_extents;
+  bool skip_unallocated = (get_allocated_extents(image, info.size,
+                                                 &allocated_extents) == 0);
+
   OrderedThrottle throttle(max_concurrent_ops, false);
   for (uint64_t offset = 0; offset < info.size; offset += period) {
     if (throttle.pending_error()) {
@@ -530,8 +579,16 @@ static int do_export_v1(librbd::Image& image, librbd::image_info_t &info,
     }
 
     uint64_t length = std::min(period, info.size - offset);
+    bool exists = (!skip_unallocated ||
+                   allocated_extents.intersects(offset, length));
+    if (!exists && fd != STDOUT_FILENO) {
+      // sparse destination file -- the trailing ftruncate covers the hole
+      pc.update_progress(offset, info.size);
+      continue;
+    }
+
     C_Export *ctx = new C_Export(throttle, image, file_size + offset, offset,
-                                 length, fd);
+                                 length, fd, exists);
     ctx->send();
 
     pc.update_progress(offset, info.size);
@@ -100,6 +100,7 @@ struct Config {
   int max_part = 255;
   int io_timeout = -1;
   int reattach_timeout = 30;
+  int num_connections = 1;
 
   bool exclusive = false;
   bool notrim = false;
@@ -158,6 +159,9 @@ static void usage()
             << "  --exclusive                   Forbid writes by other clients\n"
             << "  --notrim                      Turn off trim/discard\n"
             << "  --io-timeout <sec>            Set nbd IO timeout\n"
+            << "  --num-connections <num>       Number of nbd connections (sockets)\n"
+            << "                                (default: " << Config().num_connections << ", requires --try-netlink if > 1,\n"
+            << "                                attach must use the same number as map)\n"
             << "  --max_part <limit>            Override for module param max_part\n"
             << "  --nbds_max <limit>            Override for module param nbds_max\n"
             << "  --quiesce                     Use quiesce callbacks\n"
@@ -208,19 +212,23 @@ public:
   uint64_t quiesce_watch_handle = 0;
 
 private:
-  int fd;
+  struct Connection;
+
   librbd::Image &image;
   Config *cfg;
+  std::vector<std::unique_ptr<Connection>> connections;
 
 public:
-  NBDServer(int fd, librbd::Image& image, Config *cfg)
-    : fd(fd)
-    , image(image)
+  NBDServer(const std::vector<int> &fds, librbd::Image& image, Config *cfg)
+    : image(image)
     , cfg(cfg)
-    , reader_thread(*this, &NBDServer::reader_entry)
-    , writer_thread(*this, &NBDServer::writer_entry)
     , quiesce_thread(*this, &NBDServer::quiesce_entry)
   {
+    ceph_assert(!fds.empty());
+    for (auto fd : fds) {
+      connections.emplace_back(new Connection(*this, fd));
+    }
+
     std::vector<librbd::config_option_t> options;
     image.config_list(&options);
     for (auto &option : options) {
@@ -249,6 +257,7 @@ private:
   {
     xlist<IOContext*>::item item;
     NBDServer *server = nullptr;
+    Connection *conn = nullptr;
     struct nbd_request request;
     struct nbd_reply reply;
     bufferlist data;
@@ -263,60 +272,78 @@ private:
 
   ceph::mutex lock = ceph::make_mutex("NBDServer::Locker");
   ceph::condition_variable cond;
-  xlist<IOContext*> io_pending;
-  xlist<IOContext*> io_finished;
 
   void io_start(IOContext *ctx)
   {
-    std::lock_guard l{lock};
-    io_pending.push_back(&ctx->item);
+    Connection *conn = ctx->conn;
+    std::lock_guard l{conn->lock};
+    conn->io_pending.push_back(&ctx->item);
   }
 
   void io_finish(IOContext *ctx)
   {
-    std::lock_guard l{lock};
+    Connection *conn = ctx->conn;
+    std::lock_guard l{conn->lock};
     ceph_assert(ctx->item.is_on_list());
     ctx->item.remove_myself();
-    io_finished.push_back(&ctx->item);
-    cond.notify_all();
+    conn->io_finished.push_back(&ctx->item);
+    conn->cond.notify_all();
   }
 
-  IOContext *wait_io_finish()
+  IOContext *wait_io_finish(Connection &conn)
   {
-    std::unique_lock l{lock};
-    cond.wait(l, [this] {
-                   return !io_finished.empty() ||
-                          (io_pending.empty() && terminated);
-                 });
-
-    if (io_finished.empty())
+    std::unique_lock l{conn.lock};
+    // only give up once the reader of this connection has stopped: until
+    // then it may still queue requests which need a reply
+    conn.cond.wait(l, [&conn] {
+                        return !conn.io_finished.empty() ||
+                               (conn.io_pending.empty() && conn.reader_done);
+                      });
+
+    if (conn.io_finished.empty())
       return NULL;
 
-    IOContext *ret = io_finished.front();
-    io_finished.pop_front();
+    IOContext *ret = conn.io_finished.front();
+    conn.io_finished.pop_front();
 
     return ret;
   }
 
-  void wait_clean()
+  void wait_clean(Connection &conn)
   {
-    std::unique_lock l{lock};
-    cond.wait(l, [this] { return io_pending.empty(); });
-
-    while(!io_finished.empty()) {
-      std::unique_ptr<IOContext> free_ctx(io_finished.front());
-      io_finished.pop_front();
+    std::unique_lock l{conn.lock};
+    conn.cond.wait(l, [&conn] {
+                        return conn.io_pending.empty() && conn.reader_done;
+                      });
+
+    while(!conn.io_finished.empty()) {
+      std::unique_ptr<IOContext> free_ctx(conn.io_finished.front());
+      conn.io_finished.pop_front();
     }
   }
 
   void assert_clean()
   {
-    std::unique_lock l{lock};
+    for (auto &conn : connections) {
+      std::unique_lock l{conn->lock};
 
-    ceph_assert(!reader_thread.is_started());
-    ceph_assert(!writer_thread.is_started());
-    ceph_assert(io_pending.empty());
-    ceph_assert(io_finished.empty());
+      ceph_assert(!conn->reader_thread.is_started());
+      ceph_assert(!conn->writer_thread.is_started());
+      ceph_assert(conn->io_pending.empty());
+      ceph_assert(conn->io_finished.empty());
+    }
+  }
+
+  void terminate()
+  {
+    {
+      std::lock_guard l{lock};
+      terminated = true;
+      cond.notify_all();
+    }
+
+    std::lock_guard disconnect_l{disconnect_lock};
+    disconnect_cond.notify_all();
   }
 
   static void aio_callback(librbd::completion_t cb, void *arg)
@@ -354,8 +381,9 @@ private:
     aio_completion->release();
   }
 
-  void reader_entry()
+  void reader_entry(Connection &conn)
   {
+    int fd = conn.fd;
     struct pollfd poll_fds[2];
     memset(poll_fds, 0, sizeof(struct pollfd) * 2);
     poll_fds[0].fd = fd;
@@ -366,6 +394,7 @@ private:
     while (true) {
       std::unique_ptr<IOContext> ctx(new IOContext());
       ctx->server = this;
+      ctx->conn = &conn;
 
       dout(20) << __func__ << ": waiting for nbd request" << dendl;
 
@@ -384,6 +413,12 @@ private:
         goto signal;
       }
 
+      if (terminated) {
+        // another connection has already initiated the shut down
+        dout(20) << __func__ << ": server terminated" << dendl;
+        goto signal;
+      }
+
       if ((poll_fds[0].revents & POLLIN) == 0) {
         dout(20) << __func__ << ": nothing to read" << dendl;
         continue;
@@ -462,21 +497,23 @@ error:
       }
     }
 signal:
-    std::lock_guard l{lock};
-    terminated = true;
-    cond.notify_all();
+    terminate();
 
-    std::lock_guard disconnect_l{disconnect_lock};
-    disconnect_cond.notify_all();
+    {
+      std::lock_guard l{conn.lock};
+      conn.reader_done = true;
+      conn.cond.notify_all();
+    }
 
     dout(20) << __func__ << ": terminated" << dendl;
   }
 
-  void writer_entry()
+  void writer_entry(Connection &conn)
   {
+    int fd = conn.fd;
     while (true) {
       dout(20) << __func__ << ": waiting for io request" << dendl;
-      std::unique_ptr<IOContext> ctx(wait_io_finish());
+      std::unique_ptr<IOContext> ctx(wait_io_finish(conn));
       if (!ctx) {
 	dout(20) << __func__ << ": no io requests, terminating" << dendl;
         goto done;
@@ -484,25 +521,28 @@ signal:
 
       dout(20) << __func__ << ": got: " << *ctx << dendl;
 
-      int r = safe_write(fd, &ctx->reply, sizeof(struct nbd_reply));
+      // send the reply header and the read payload (if any) with a single
+      // writev(2) call, referencing the header in place instead of copying
+      bufferlist reply;
+      reply.push_back(buffer::create_static(sizeof(struct nbd_reply),
+                                            (char *)&ctx->reply));
+      if (ctx->command == NBD_CMD_READ && ctx->reply.error == htonl(0)) {
+        reply.claim_append(ctx->data);
+      }
+      int r = reply.write_fd(fd);
       if (r < 0) {
-	derr << *ctx << ": failed to write reply header: " << cpp_strerror(r)
+	derr << *ctx << ": failed to write reply: " << cpp_strerror(r)
 	     << dendl;
         goto error;
       }
-      if (ctx->command == NBD_CMD_READ && ctx->reply.error == htonl(0)) {
-	r = ctx->data.write_fd(fd);
-        if (r < 0) {
-	  derr << *ctx << ": failed to write replay data: " << cpp_strerror(r)
-	       << dendl;
-          goto error;
-	}
-      }
       dout(20) << *ctx << ": finish" << dendl;
     }
   error:
-    wait_clean();
+    // the reply stream is broken: kick the reader out of poll(2) so that it
+    // stops queueing requests
+    ::shutdown(fd, SHUT_RDWR);
   done:
+    wait_clean(conn);
     ::shutdown(fd, SHUT_RDWR);
 
     dout(20) << __func__ << ": terminated" << dendl;
@@ -601,7 +641,51 @@ signal:
       (server.*func)();
       return NULL;
     }
-  } reader_thread, writer_thread, quiesce_thread;
+  } quiesce_thread;
+
+  class ConnectionThreadHelper : public Thread
+  {
+  public:
+    typedef void (NBDServer::*entry_func)(Connection &);
+  private:
+    NBDServer &server;
+    Connection &conn;
+    entry_func func;
+  public:
+    ConnectionThreadHelper(NBDServer &_server, Connection &_conn,
+                           entry_func _func)
+      :server(_server)
+      ,conn(_conn)
+      ,func(_func)
+    {}
+  protected:
+    void* entry() override
+    {
+      (server.*func)(conn);
+      return NULL;
+    }
+  };
+
+  // each nbd connection (socket) is served by its own reader/writer pair
+  // so that the kernel blk-mq hardware queues are processed in parallel
+  struct Connection
+  {
+    int fd;
+    ceph::mutex lock;
+    ceph::condition_variable cond;
+    xlist<IOContext*> io_pending;
+    xlist<IOContext*> io_finished;
+    bool reader_done = false;
+    ConnectionThreadHelper reader_thread;
+    ConnectionThreadHelper writer_thread;
+
+    Connection(NBDServer &server, int fd)
+      : fd(fd)
+      , lock(ceph::make_mutex("NBDServer::Connection::Locker"))
+      , reader_thread(server, *this, &NBDServer::reader_entry)
+      , writer_thread(server, *this, &NBDServer::writer_entry)
+    {}
+  };
 
   bool started = false;
   bool quiesce = false;
@@ -620,8 +704,10 @@ public:
                                         EVENT_SOCKET_TYPE_EVENTFD);
       ceph_assert(r >= 0);
 
-      reader_thread.create("rbd_reader");
-      writer_thread.create("rbd_writer");
+      for (auto &conn : connections) {
+        conn->reader_thread.create("rbd_reader");
+        conn->writer_thread.create("rbd_writer");
+      }
       if (cfg->quiesce) {
         quiesce_thread.create("rbd_quiesce");
       }
@@ -666,8 +752,10 @@ public:
 
       terminate_event_sock.notify();
 
-      reader_thread.join();
-      writer_thread.join();
+      for (auto &conn : connections) {
+        conn->reader_thread.join();
+        conn->writer_thread.join();
+      }
       if (cfg->quiesce) {
         quiesce_thread.join();
       }
@@ -1343,8 +1431,9 @@ static int netlink_connect_cb(struct nl_msg *msg, void *arg)
   return NL_OK;
 }
 
-static int netlink_connect(Config *cfg, struct nl_sock *sock, int nl_id, int fd,
-                           uint64_t size, uint64_t flags, bool reconnect)
+static int netlink_connect(Config *cfg, struct nl_sock *sock, int nl_id,
+                           const std::vector<int> &fds, uint64_t size,
+                           uint64_t flags, bool reconnect)
 {
   struct nlattr *sock_attr;
   struct nlattr *sock_opt;
@@ -1399,14 +1488,16 @@ static int netlink_connect(Config *cfg, struct nl_sock *sock, int nl_id, int fd,
     goto free_msg;
   }
 
-  sock_opt = nla_nest_start(msg, NBD_SOCK_ITEM);
-  if (!sock_opt) {
-    cerr << "rbd-nbd: Could not init sock in netlink message." << std::endl;
-    goto free_msg;
-  }
+  for (auto fd : fds) {
+    sock_opt = nla_nest_start(msg, NBD_SOCK_ITEM);
+    if (!sock_opt) {
+      cerr << "rbd-nbd: Could not init sock in netlink message." << std::endl;
+      goto free_msg;
+    }
 
-  NLA_PUT_U32(msg, NBD_SOCK_FD, fd);
-  nla_nest_end(msg, sock_opt);
+    NLA_PUT_U32(msg, NBD_SOCK_FD, fd);
+    nla_nest_end(msg, sock_opt);
+  }
   nla_nest_end(msg, sock_attr);
 
   ret = nl_send_sync(sock, msg);
@@ -1425,8 +1516,8 @@ free_msg:
   return -EIO;
 }
 
-static int try_netlink_setup(Config *cfg, int fd, uint64_t size, uint64_t flags,
-                             bool reconnect)
+static int try_netlink_setup(Config *cfg, const std::vector<int> &fds,
+                             uint64_t size, uint64_t flags, bool reconnect)
 {
   struct nl_sock *sock;
   int nl_id, ret;
@@ -1440,7 +1531,7 @@ static int try_netlink_setup(Config *cfg, int fd, uint64_t size, uint64_t flags,
 
   dout(10) << "netlink interface supported." << dendl;
 
-  ret = netlink_connect(cfg, sock, nl_id, fd, size, flags, reconnect);
+  ret = netlink_connect(cfg, sock, nl_id, fds, size, flags, reconnect);
   netlink_cleanup(sock);
 
   if (ret != 0)
@@ -1496,11 +1587,12 @@ static void handle_signal(int signum)
   terminate_event_sock.notify();
 }
 
-static NBDServer *start_server(int fd, librbd::Image& image, Config *cfg)
+static NBDServer *start_server(const std::vector<int> &fds,
+                               librbd::Image& image, Config *cfg)
 {
   NBDServer *server;
 
-  server = new NBDServer(fd, image, cfg);
+  server = new NBDServer(fds, image, cfg);
   server->start();
 
   init_async_signal_handler();
@@ -1626,7 +1718,9 @@ static int do_map(int argc, const char *argv[], Config *cfg, bool reconnect)
   unsigned long blksize = RBD_NBD_BLKSIZE;
   bool use_netlink;
 
-  int fd[2];
+  // kernel and server side ends of the nbd connection socket pairs
+  std::vector<int> client_fds;
+  std::vector<int> server_fds;
 
   librbd::image_info_t info;
 
@@ -1667,9 +1761,14 @@ static int do_map(int argc, const char *argv[], Config *cfg, bool reconnect)
   common_init_finish(g_ceph_context);
   global_init_chdir(g_ceph_context);
 
-  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fd) == -1) {
-    r = -errno;
-    goto close_ret;
+  for (int i = 0; i < cfg->num_connections; i++) {
+    int fd[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fd) == -1) {
+      r = -errno;
+      goto close_fd;
+    }
+    client_fds.push_back(fd[0]);
+    server_fds.push_back(fd[1]);
   }
 
   r = rados.init_with_context(g_ceph_context);
@@ -1799,7 +1898,7 @@ static int do_map(int argc, const char *argv[], Config *cfg, bool reconnect)
   if (r < 0)
     goto close_fd;
 
-  server = start_server(fd[1], image, cfg);
+  server = start_server(server_fds, image, cfg);
 
   use_netlink = cfg->try_netlink || reconnect;
   if (use_netlink) {
@@ -1809,7 +1908,7 @@ static int do_map(int argc, const char *argv[], Config *cfg, bool reconnect)
       uuid_gen.generate_random();
       cfg->cookie = uuid_gen.to_string();
     }
-    r = try_netlink_setup(cfg, fd[0], size, flags, reconnect);
+    r = try_netlink_setup(cfg, client_fds, size, flags, reconnect);
     if (r < 0) {
       goto free_server;
     } else if (r == 1) {
@@ -1818,7 +1917,14 @@ static int do_map(int argc, const char *argv[], Config *cfg, bool reconnect)
   }
 
   if (!use_netlink) {
-    r = try_ioctl_setup(cfg, fd[0], size, blksize, flags);
+    if (client_fds.size() > 1) {
+      // parse_args() requires --try-netlink, but the kernel may lack it
+      r = -EOPNOTSUPP;
+      cerr << "rbd-nbd: multiple connections require the netlink interface, "
+           << "which is not supported by the kernel" << std::endl;
+      goto free_server;
+    }
+    r = try_ioctl_setup(cfg, client_fds[0], size, blksize, flags);
     if (r < 0)
       goto free_server;
   }
@@ -1887,9 +1993,12 @@ close_nbd:
 free_server:
   delete server;
 close_fd:
-  close(fd[0]);
-  close(fd[1]);
-close_ret:
+  for (auto fd : client_fds) {
+    close(fd);
+  }
+  for (auto fd : server_fds) {
+    close(fd);
+  }
   image.close();
   io_ctx.close();
   rados.shutdown();
@@ -2157,6 +2266,16 @@ static int parse_args(vector<const char*>& args, std::ostream *err_msg,
                                      (char *)NULL)) {
     } else if (ceph_argparse_flag(args, i, "--pretty-format", (char *)NULL)) {
       cfg->pretty_format = true;
+    } else if (ceph_argparse_witharg(args, i, &cfg->num_connections, err,
+                                     "--num-connections", (char *)NULL)) {
+      if (!err.str().empty()) {
+        *err_msg << "rbd-nbd: " << err.str();
+        return -EINVAL;
+      }
+      if (cfg->num_connections < 1) {
+        *err_msg << "rbd-nbd: Invalid argument for num-connections!";
+        return -EINVAL;
+      }
     } else if (ceph_argparse_flag(args, i, "--try-netlink", (char *)NULL)) {
       cfg->try_netlink = true;
     } else if (ceph_argparse_flag(args, i, "--show-cookie", (char *)NULL)) {
@@ -2288,6 +2407,12 @@ static int parse_args(vector<const char*>& args, std::ostream *err_msg,
     return -EINVAL;
   }
 
+  // the ioctl interface takes a single socket (attach always uses netlink)
+  if (cmd == Map && cfg->num_connections > 1 && !cfg->try_netlink) {
+    *err_msg << "rbd-nbd: multiple connections require --try-netlink";
+    return -EINVAL;
+  }
+
   if (args.begin() != args.end()) {
     *err_msg << "rbd-nbd: unknown args: " << *args.begin();
     return -EINVAL;